@@ -0,0 +1,78 @@
+#include "darparu/benchmarks/benchmark.h"
+#include "darparu/renderer/algebra.h"
+#include "darparu/renderer/simd_algebra.h"
+#include <array>
+#include <vector>
+
+using namespace darparu;
+
+int main(int argc, char *argv[]) {
+  benchmarks::Benchmarks benchmarks;
+
+  const std::array<float, 3> eye = {2.5f, 3.5f, 2.5f};
+  const std::array<float, 3> center = {0.0f, 0.5f, 0.0f};
+  const std::array<float, 3> up = {0.0f, 1.0f, 0.0f};
+  const auto view = renderer::look_at(eye, center, up);
+  const auto projection = renderer::perspective(renderer::radians(60), 1.0f, 0.001f, 100.0f);
+
+  benchmarks.add("multiply_matrices", [&](size_t iterations) {
+    auto a = projection, b = view;
+    for (size_t i = 0; i < iterations; ++i) {
+      // Opaque inputs so the product is recomputed every iteration.
+      benchmarks::do_not_optimize(a);
+      benchmarks::do_not_optimize(b);
+      benchmarks::do_not_optimize(renderer::multiply_matrices(a, b));
+    }
+  });
+
+  benchmarks.add("inverse", [&](size_t iterations) {
+    auto matrix = renderer::multiply_matrices(projection, view);
+    for (size_t i = 0; i < iterations; ++i) {
+      benchmarks::do_not_optimize(matrix);
+      benchmarks::do_not_optimize(renderer::inverse(matrix));
+    }
+  });
+
+  benchmarks.add("multiply_matrix", [&](size_t iterations) {
+    auto matrix = renderer::multiply_matrices(projection, view);
+    std::array<float, 4> position = {0.5f, 0.25f, -0.5f, 1.0f};
+    for (size_t i = 0; i < iterations; ++i) {
+      benchmarks::do_not_optimize(matrix);
+      benchmarks::do_not_optimize(position);
+      benchmarks::do_not_optimize(renderer::multiply_matrix(matrix, position));
+    }
+  });
+
+  // A batch the size of a small mesh, transformed one wrapper call at a time and with the matrix loaded once.
+  std::vector<std::array<float, 4>> positions(1024);
+  for (size_t i = 0; i < positions.size(); ++i)
+    positions[i] = {static_cast<float>(i % 32), 0.0f, static_cast<float>(i / 32), 1.0f};
+  std::vector<std::array<float, 4>> transformed(positions.size());
+
+  benchmarks.add("multiply_matrix_1024", [&](size_t iterations) {
+    const auto matrix = renderer::multiply_matrices(projection, view);
+    for (size_t i = 0; i < iterations; ++i) {
+      for (size_t j = 0; j < positions.size(); ++j)
+        transformed[j] = renderer::multiply_matrix(matrix, positions[j]);
+      benchmarks::do_not_optimize(transformed);
+    }
+  });
+
+  benchmarks.add("transform_1024", [&](size_t iterations) {
+    const auto matrix = renderer::Mat4::load(renderer::multiply_matrices(projection, view));
+    for (size_t i = 0; i < iterations; ++i) {
+      renderer::transform(matrix, positions, transformed);
+      benchmarks::do_not_optimize(transformed);
+    }
+  });
+
+  benchmarks.add("look_at", [&](size_t iterations) {
+    auto position = eye;
+    for (size_t i = 0; i < iterations; ++i) {
+      benchmarks::do_not_optimize(position);
+      benchmarks::do_not_optimize(renderer::look_at(position, center, up));
+    }
+  });
+
+  return benchmarks.run(argc, argv);
+}
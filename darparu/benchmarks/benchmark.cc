@@ -0,0 +1,150 @@
+#include "darparu/benchmarks/benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+
+namespace darparu::benchmarks {
+
+struct Options {
+  std::string filter;
+  double min_time_seconds = 0.1;
+  size_t repetitions = 5;
+  std::string json_path;
+  std::string baseline_path;
+  double threshold_percent = 10.0;
+};
+
+static Options parse_options(int argc, char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    const size_t equals = argument.find('=');
+    const std::string_view name = argument.substr(0, equals);
+    const std::string value(equals == std::string_view::npos ? "" : argument.substr(equals + 1));
+    if (name == "--filter")
+      options.filter = value;
+    else if (name == "--min_time")
+      options.min_time_seconds = std::stod(value);
+    else if (name == "--repetitions")
+      options.repetitions = std::stoul(value);
+    else if (name == "--json")
+      options.json_path = value;
+    else if (name == "--baseline")
+      options.baseline_path = value;
+    else if (name == "--threshold")
+      options.threshold_percent = std::stod(value);
+    else
+      throw std::invalid_argument("Unknown benchmark option " + std::string(argument));
+  }
+  if (options.min_time_seconds <= 0.0 || options.repetitions == 0)
+    throw std::invalid_argument("Invalid benchmark options");
+  return options;
+}
+
+static double time_ns(const Benchmarks::Function &function, size_t iterations) {
+  const auto start = std::chrono::steady_clock::now();
+  function(iterations);
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static BenchmarkResult measure(const std::string &name, const Benchmarks::Function &function, const Options &options) {
+  const double min_time_ns = options.min_time_seconds * 1e9;
+  // Grow the iterations geometrically, aiming a little over the minimum time to not overshoot it by much.
+  size_t iterations = 1;
+  for (double elapsed_ns = time_ns(function, iterations); elapsed_ns < min_time_ns;
+       elapsed_ns = time_ns(function, iterations)) {
+    const double scale = elapsed_ns > 0.0 ? std::clamp(1.2 * min_time_ns / elapsed_ns, 2.0, 100.0) : 100.0;
+    iterations = static_cast<size_t>(static_cast<double>(iterations) * scale);
+  }
+
+  std::vector<double> per_iteration_ns(options.repetitions);
+  for (auto &ns : per_iteration_ns)
+    ns = time_ns(function, iterations) / static_cast<double>(iterations);
+  std::sort(per_iteration_ns.begin(), per_iteration_ns.end());
+  return {name, iterations, per_iteration_ns[per_iteration_ns.size() / 2], per_iteration_ns.front()};
+}
+
+static void write_json(std::ostream &stream, const std::vector<BenchmarkResult> &results) {
+  // One benchmark per line, which read_baseline relies on. Names are plain identifiers, so need no escaping.
+  stream << std::setprecision(6) << "{\"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto &result = results[i];
+    stream << "  {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+           << ", \"median_ns\": " << result.median_ns << ", \"min_ns\": " << result.min_ns << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  stream << "]}\n";
+}
+
+// Reads the medians of a file written by write_json.
+static std::map<std::string, double> read_baseline(const std::string &path) {
+  std::ifstream file(path);
+  if (!file)
+    throw std::runtime_error("Could not open benchmark baseline " + path);
+  std::map<std::string, double> medians;
+  constexpr std::string_view NAME = "\"name\": \"";
+  constexpr std::string_view MEDIAN = "\"median_ns\": ";
+  for (std::string line; std::getline(file, line);) {
+    const size_t name = line.find(NAME);
+    const size_t median = line.find(MEDIAN);
+    if (name == std::string::npos || median == std::string::npos)
+      continue;
+    const size_t name_begin = name + NAME.size();
+    medians[line.substr(name_begin, line.find('"', name_begin) - name_begin)] =
+        std::stod(line.substr(median + MEDIAN.size()));
+  }
+  return medians;
+}
+
+void Benchmarks::add(std::string name, Function function) {
+  _benchmarks.emplace_back(std::move(name), std::move(function));
+}
+
+int Benchmarks::run(int argc, char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  const auto baseline =
+      options.baseline_path.empty() ? std::map<std::string, double>{} : read_baseline(options.baseline_path);
+
+  // Keeps standard output machine readable when the JSON goes there.
+  std::ostream &table = options.json_path == "-" ? std::cerr : std::cout;
+  std::vector<BenchmarkResult> results;
+  size_t regressions = 0;
+  table << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(14) << "median ns" << std::setw(14)
+        << "min ns" << std::setw(14) << "iterations" << (baseline.empty() ? "" : "      baseline ns   change") << "\n";
+  for (const auto &[name, function] : _benchmarks) {
+    if (name.find(options.filter) == std::string::npos)
+      continue;
+    const auto &result = results.emplace_back(measure(name, function, options));
+    table << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(1) << std::setw(14)
+          << result.median_ns << std::setw(14) << result.min_ns << std::setw(14) << result.iterations;
+    if (auto it = baseline.find(name); it != baseline.end()) {
+      const double change_percent = (result.median_ns / it->second - 1.0) * 100.0;
+      const bool regressed = change_percent > options.threshold_percent;
+      regressions += regressed;
+      table << std::setw(17) << it->second << std::showpos << std::setw(8) << change_percent << "%" << std::noshowpos
+            << (regressed ? "  regressed" : "");
+    }
+    table << std::defaultfloat << std::endl;
+  }
+
+  if (options.json_path == "-") {
+    write_json(std::cout, results);
+  } else if (!options.json_path.empty()) {
+    std::ofstream file(options.json_path);
+    if (!file)
+      throw std::runtime_error("Could not write benchmark results to " + options.json_path);
+    write_json(file, results);
+  }
+  if (regressions > 0) {
+    std::cerr << regressions << " benchmark(s) regressed by more than " << options.threshold_percent << "%\n";
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace darparu::benchmarks
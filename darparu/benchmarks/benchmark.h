@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace darparu::benchmarks {
+
+// Keeps the compiler from optimising away the computation of a value.
+template <typename T> inline void do_not_optimize(const T &value) {
+#if defined(_MSC_VER)
+  static const void *volatile sink;
+  sink = &value;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "m"(value) : "memory");
+#endif
+}
+
+struct BenchmarkResult {
+  std::string name;
+  // Per repetition.
+  size_t iterations;
+  double median_ns;
+  double min_ns;
+};
+
+// A minimal benchmark runner. Each benchmark is a function running its body a given number of times. The number of
+// iterations is calibrated until a repetition takes at least the minimum time, then the median and minimum time per
+// iteration of several repetitions are reported.
+//
+// Options:
+//   --filter=<substring>     only runs benchmarks whose name contains it
+//   --min_time=<seconds>     minimum duration of a repetition, 0.1 by default
+//   --repetitions=<n>        5 by default
+//   --json=<path>            writes the results as JSON, - for standard output
+//   --baseline=<path>        compares the medians with the results of an earlier --json run, failing on regressions
+//   --threshold=<percent>    slowdown counted as a regression, 10 by default
+class Benchmarks {
+public:
+  using Function = std::function<void(size_t iterations)>;
+
+  void add(std::string name, Function function);
+
+  // Parses the options, runs the benchmarks and returns the process exit code.
+  int run(int argc, char *argv[]);
+
+private:
+  std::vector<std::pair<std::string, Function>> _benchmarks;
+};
+
+} // namespace darparu::benchmarks
@@ -0,0 +1,75 @@
+#include "darparu/benchmarks/benchmark.h"
+#include "darparu/renderer/entities/ball_mesh.h"
+#include "darparu/renderer/entities/mesh_2d.h"
+#include "darparu/renderer/entities/water.h"
+#include "darparu/renderer/entities/water_normals.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace darparu;
+
+// The inputs of update_water_normals for a resolution by resolution water surface of ripples, as Water sets them up.
+struct WaterNormalsInput {
+  std::vector<float> heights;
+  std::vector<float> xz;
+  std::vector<unsigned int> indices;
+  std::vector<size_t> count;
+};
+
+static WaterNormalsInput water_normals_input(size_t resolution) {
+  auto grid = renderer::entities::grid_vertices_normals_and_indices(resolution, resolution, 1.0 / (resolution - 1));
+  WaterNormalsInput input{std::vector<float>(resolution * resolution), std::move(grid.vertices),
+                          std::move(grid.indices), std::vector<size_t>(resolution * resolution, 0)};
+  for (size_t i = 0; i < input.heights.size(); ++i)
+    input.heights[i] = 0.5f + 0.05f * std::sin(20.0f * input.xz[2 * i]) * std::cos(20.0f * input.xz[2 * i + 1]);
+  for (auto index : input.indices)
+    ++input.count[index];
+  return input;
+}
+
+int main(int argc, char *argv[]) {
+  benchmarks::Benchmarks benchmarks;
+
+  for (size_t resolution : {64, 128, 256, 512}) {
+    // Set up once, outside the timed function.
+    const auto input = water_normals_input(resolution);
+    std::vector<float> vertex_normals(3 * resolution * resolution);
+    std::vector<float> face_normals((resolution - 1) * (resolution - 1) * 2 * 3);
+    benchmarks.add("update_water_normals/" + std::to_string(resolution),
+                   [resolution, input, vertex_normals, face_normals](size_t iterations) mutable {
+                     for (size_t i = 0; i < iterations; ++i) {
+                       renderer::entities::update_water_normals(vertex_normals, face_normals, input.heights,
+                                                                resolution, input.xz, input.indices, input.count);
+                       benchmarks::do_not_optimize(vertex_normals.data());
+                     }
+                   });
+  }
+
+  for (int resolution : {64, 256, 512}) {
+    benchmarks.add("grid_vertices_normals_and_indices/" + std::to_string(resolution), [resolution](size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i)
+        benchmarks::do_not_optimize(
+            renderer::entities::grid_vertices_normals_and_indices(resolution, resolution, 1.0 / (resolution - 1)));
+    });
+  }
+
+  benchmarks.add("create_ball_mesh", [](size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i)
+      benchmarks::do_not_optimize(renderer::entities::create_ball_mesh());
+  });
+
+  for (size_t count : {1000, 100000}) {
+    std::vector<float> vertices(2 * count), colors(3 * count);
+    for (size_t i = 0; i < vertices.size(); ++i)
+      vertices[i] = static_cast<float>(i);
+    for (size_t i = 0; i < colors.size(); ++i)
+      colors[i] = static_cast<float>(i % 3) / 2.0f;
+    benchmarks.add("interleave_vertices_and_colors/" + std::to_string(count), [vertices, colors](size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i)
+        benchmarks::do_not_optimize(renderer::entities::interleave_vertices_and_colors(vertices, colors));
+    });
+  }
+
+  return benchmarks.run(argc, argv);
+}
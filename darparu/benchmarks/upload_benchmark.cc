@@ -0,0 +1,47 @@
+#include "darparu/benchmarks/benchmark.h"
+#include "darparu/renderer/cameras/orbit.h"
+#include "darparu/renderer/entities/water.h"
+#include "darparu/renderer/io_control.h"
+#include "darparu/renderer/renderer.h"
+#include <GL/glew.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace darparu;
+
+// Times Water::set_heights, which computes the normals and uploads heights and normals, through to the GPU having
+// consumed the upload. Runs on the headless backend, so it needs no display.
+int main(int argc, char *argv[]) {
+  renderer::init(renderer::Backend::headless);
+  int exit_code;
+  {
+    // Only provides the GL context.
+    renderer::Renderer renderer("Upload benchmark", 64, 64, std::make_shared<renderer::IoControl>(),
+                                std::make_shared<renderer::OrbitCamera>(std::array<float, 3>{0.0f, 1.0f, 1.0f},
+                                                                        std::array<float, 2>{0.0f, 0.7853982f}),
+                                0.001f, 100.0f);
+
+    benchmarks::Benchmarks benchmarks;
+    for (auto format : {renderer::entities::WaterVertexFormat::full, renderer::entities::WaterVertexFormat::compact}) {
+      for (size_t resolution : {101, 256, 512}) {
+        auto water = std::make_shared<renderer::entities::Water>(resolution, 0.0f, format);
+        std::vector<float> heights(resolution * resolution);
+        for (size_t i = 0; i < heights.size(); ++i)
+          heights[i] = 0.5f + 0.05f * std::sin(0.3f * static_cast<float>(i % resolution)) *
+                                  std::cos(0.3f * static_cast<float>(i / resolution));
+        const std::string name = format == renderer::entities::WaterVertexFormat::full ? "full" : "compact";
+        benchmarks.add("water_set_heights/" + name + "/" + std::to_string(resolution),
+                       [water, heights](size_t iterations) {
+                         for (size_t i = 0; i < iterations; ++i)
+                           water->set_heights(heights);
+                         glFinish();
+                       });
+      }
+    }
+    exit_code = benchmarks.run(argc, argv);
+  }
+  renderer::terminate();
+  return exit_code;
+}
@@ -0,0 +1,67 @@
+#include "darparu/bin/darparu_scene.h"
+#include "darparu/renderer/cameras/orbit.h"
+#include "darparu/renderer/io_controls/camera_path.h"
+#include "darparu/renderer/io_controls/recording.h"
+#include "darparu/renderer/memory_tracker.h"
+#include "darparu/renderer/renderer.h"
+#include "math.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace darparu;
+
+// Renders the darparu scene offscreen while orbiting the camera once around it, then prints frame and GPU time
+// statistics.
+// Frames are written as PPM images when given a capture directory.
+// Set DARPARU_REPLAY to a camera recording to replay it instead of orbiting, in which case frames is ignored.
+// Usage: darparu_headless [frames] [capture directory]
+int main(int argc, char *argv[]) {
+  size_t frames = argc > 1 ? std::stoul(argv[1]) : 300;
+
+  renderer::init(renderer::Backend::headless);
+
+  const std::array<float, 3> camera_position = {2.5, 3.535534, 2.5};
+  const std::array<float, 2> camera_radians = {0.7853982, 0.7853982};
+  std::shared_ptr<renderer::IoControl> control;
+  if (const char *replay_path = std::getenv("DARPARU_REPLAY")) {
+    auto replay = std::make_shared<renderer::ReplayIoControl>(replay_path);
+    frames = replay->records().size();
+    control = replay;
+  } else {
+    control = std::make_shared<renderer::CameraPathIoControl>(
+        std::vector<renderer::CameraKeyframe>{
+            {camera_position, camera_radians},
+            {camera_position, {camera_radians[0] + static_cast<float>(2.0 * M_PI), camera_radians[1]}}},
+        frames);
+  }
+  renderer::Renderer renderer("Darparu", 1080, 1080, control,
+                              std::make_shared<renderer::OrbitCamera>(camera_position, camera_radians), 0.001, 100.0);
+  renderer.set_pipeline(renderer::RenderPipeline::single_pass);
+  if (argc > 2)
+    renderer.set_frame_capture(std::make_shared<renderer::FrameCapture>(argv[2]));
+
+  const auto scene = build_darparu_scene(renderer);
+
+  renderer.gpu_profiler().set_enabled(true);
+
+  renderer.frame_stats().set_window(frames);
+
+  while (!renderer.should_close())
+    renderer.render();
+
+  std::cout << renderer.frame_stats().summary() << "\n";
+  const auto &profiler = renderer.gpu_profiler();
+  std::cout << "GPU frame: " << profiler.milliseconds("frame") << "ms\n"
+            << "GPU refraction pass: " << profiler.milliseconds("refraction pass") << "ms\n"
+            << "GPU main pass: " << profiler.milliseconds("main pass") << "ms\n"
+            << "GPU scenery: " << profiler.milliseconds(scene.scenery.get()) << "ms\n"
+            << "GPU balls: " << profiler.milliseconds(scene.balls.get()) << "ms\n"
+            << "GPU water: " << profiler.milliseconds(scene.water.get()) << "ms\n";
+  std::cout << renderer::memory_tracker() << "\n";
+  renderer.set_frame_capture(nullptr);
+  renderer::terminate();
+
+  return 0;
+}
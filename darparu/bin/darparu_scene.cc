@@ -0,0 +1,62 @@
+#include "darparu/bin/darparu_scene.h"
+#include "darparu/renderer/algebra.h"
+#include "darparu/renderer/entities/container.h"
+#include "darparu/renderer/entities/light.h"
+#include <vector>
+
+namespace darparu {
+
+constexpr size_t RESOLUTION = 101;
+constexpr float SPACING = 0.02;
+constexpr float WALL_THICKNESS = 0.1;
+
+struct BallConfig {
+  std::array<float, 3> color;
+  std::array<float, 3> position;
+  float radius;
+};
+
+DarparuScene build_darparu_scene(renderer::Renderer &renderer) {
+  std::vector<BallConfig> ball_configs = {{{1.0, 0.0, 0.0}, {-0.5, 1.0, -0.5}, 0.2},
+                                          {{0.0, 1.0, 0.0}, {0.5, 1.0, -0.5}, 0.3},
+                                          {{0.0, 0.0, 1.0}, {0.5, 1.0, 0.5}, 0.25}};
+
+  auto light_position = std::array<float, 3>{0.0, 4.0, 0.0};
+  renderer.set_light_position(light_position);
+  renderer.set_light_color({1.0, 1.0, 1.0});
+
+  // The light cube and container never move, so they are merged into one draw.
+  auto scenery = std::make_shared<renderer::entities::StaticBatch>();
+  renderer._renderables.emplace_back(scenery, true);
+  auto light_model = renderer::translate(renderer::scale(renderer::eye4d(), {0.2, 0.2, 0.2}), light_position);
+  scenery->add(renderer::entities::light_geometry(), renderer::transpose(light_model), {1.0, 1.0, 1.0}, true);
+  auto container_water_model = renderer::eye4d();
+  scenery->add(renderer::entities::container_geometry((RESOLUTION - 1) * SPACING, WALL_THICKNESS),
+               renderer::transpose(container_water_model), {0.7, 0.7, 0.7});
+  scenery->build();
+  scenery->set_model(renderer::eye4d());
+
+  auto balls = std::make_shared<renderer::entities::BallBatch>();
+  renderer._renderables.emplace_back(balls, true);
+  balls->set_model(renderer::eye4d());
+  std::vector<renderer::entities::BallInstance> ball_instances;
+  for (const auto &config : ball_configs)
+    ball_instances.push_back(
+        {{config.position[0], config.position[1], config.position[2], config.radius}, config.color});
+  balls->set_instances(ball_instances);
+
+  auto water = std::make_shared<renderer::entities::Water>(RESOLUTION, 0.0f);
+  renderer._renderables.emplace_back(water, false);
+  water->set_color({0.0, 0.0, 1.0});
+  water->set_model(
+      renderer::transpose(renderer::scale(container_water_model, {RESOLUTION * SPACING, 1.0, RESOLUTION * SPACING})));
+
+  auto texture = renderer._camera_texture.texture();
+  water->set_texture(texture);
+
+  water->set_heights(std::vector<float>(RESOLUTION * RESOLUTION, 0.8f));
+
+  return {scenery, balls, water};
+}
+
+} // namespace darparu
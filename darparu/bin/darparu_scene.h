@@ -0,0 +1,21 @@
+#pragma once
+#include "darparu/renderer/entities/ball_batch.h"
+#include "darparu/renderer/entities/static_batch.h"
+#include "darparu/renderer/entities/water.h"
+#include "darparu/renderer/renderer.h"
+#include <memory>
+
+namespace darparu {
+
+struct DarparuScene {
+  // The light cube and the container.
+  std::shared_ptr<renderer::entities::StaticBatch> scenery;
+  std::shared_ptr<renderer::entities::BallBatch> balls;
+  std::shared_ptr<renderer::entities::Water> water;
+};
+
+// Lights the renderer and adds the scene shared by the darparu binaries to it: the container of still water refracting
+// three balls.
+DarparuScene build_darparu_scene(renderer::Renderer &renderer);
+
+} // namespace darparu
@@ -5,12 +5,9 @@
 #include "darparu/renderer/projection_context.h"
 #include "darparu/renderer/renderer.h"
 #include "math.h"
-#include <chrono>
 #include <cstdlib>
 #include <vector>
 
-using namespace std::chrono_literals;
-
 using namespace darparu;
 
 int main() {
@@ -35,19 +32,13 @@ int main() {
 
   auto mesh = std::make_shared<renderer::entities::Mesh2d>(vertices, indices, colors);
   renderer._renderables.emplace_back(mesh, false);
-  mesh->set_projection(renderer::eye4d());
   mesh->set_model(renderer::eye4d());
-  mesh->set_view(renderer::eye4d());
 
-  auto us = 1us;
-  auto start = std::chrono::high_resolution_clock::now();
-  while (!renderer.should_close()) {
+  renderer.set_redraw_mode(renderer::RedrawMode::on_demand);
+  renderer.set_frame_rate_limit(60.0);
+
+  while (!renderer.should_close())
     renderer.render();
-    auto end = std::chrono::high_resolution_clock::now();
-    us = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    std::cout << "Frame time: " << us.count() << "us\n";
-    start = end;
-  }
   renderer::terminate();
   return 0;
 }
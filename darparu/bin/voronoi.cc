@@ -7,15 +7,12 @@
 #include "darparu/triangulate_2d.h"
 #include "math.h"
 #include <algorithm>
-#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <vector>
 
-using namespace std::chrono_literals;
-
 using namespace darparu;
 
 std::vector<std::vector<double>> load_voronoi_faces(const std::string &file_path) {
@@ -102,19 +99,13 @@ int main() {
       std::make_shared<renderer::PanCamera>(std::array<float, 3>{-0.126, 51, -20.0}), -1000.0, 1000.0);
   auto mesh = std::make_shared<renderer::entities::Mesh2d>(vertices, indices, colors);
   renderer._renderables.emplace_back(mesh, false);
-  mesh->set_projection(renderer::eye4d());
   mesh->set_model(renderer::eye4d());
-  mesh->set_view(renderer::eye4d());
 
-  auto us = 1us;
-  auto start = std::chrono::high_resolution_clock::now();
-  while (!renderer.should_close()) {
+  renderer.set_redraw_mode(renderer::RedrawMode::on_demand);
+  renderer.set_frame_rate_limit(60.0);
+
+  while (!renderer.should_close())
     renderer.render();
-    auto end = std::chrono::high_resolution_clock::now();
-    us = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    std::cout << "Frame time: " << us.count() << "us\n";
-    start = end;
-  }
   renderer::terminate();
   return 0;
 }
@@ -0,0 +1,158 @@
+#include "darparu/profile.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace darparu::profile {
+
+namespace {
+
+struct Event {
+  const char *name;
+  std::uint64_t begin;
+  std::uint64_t end;
+};
+
+// A fixed size ring of the thread's latest zones, written by its thread only, so memory stays bounded however long the
+// process runs. Writes are published seqlock style: started is bumped before a slot is overwritten and written after,
+// so readers can tell which of the events they copied were overwritten meanwhile and the writer never waits.
+struct ThreadBuffer {
+  static constexpr size_t CAPACITY = 1 << 16;
+
+  struct Slot {
+    std::atomic<const char *> name;
+    std::atomic<std::uint64_t> begin;
+    std::atomic<std::uint64_t> end;
+  };
+
+  size_t thread_index;
+  std::array<Slot, CAPACITY> slots;
+  std::atomic<std::uint64_t> started = 0;
+  std::atomic<std::uint64_t> written = 0;
+
+  void record(const Event &event) {
+    const std::uint64_t index = written.load(std::memory_order_relaxed);
+    started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot &slot = slots[index % CAPACITY];
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.begin.store(event.begin, std::memory_order_relaxed);
+    slot.end.store(event.end, std::memory_order_relaxed);
+    written.store(index + 1, std::memory_order_release);
+  }
+
+  // The events still in the ring, oldest first.
+  std::vector<Event> events() const {
+    const std::uint64_t end = written.load(std::memory_order_acquire);
+    std::uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    std::vector<Event> events;
+    events.reserve(end - begin);
+    for (std::uint64_t i = begin; i < end; ++i) {
+      const Slot &slot = slots[i % CAPACITY];
+      events.push_back({slot.name.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+                        slot.end.load(std::memory_order_relaxed)});
+    }
+    // Slots of events before started - CAPACITY may have been overwritten while they were copied.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t started_after = started.load(std::memory_order_relaxed);
+    const std::uint64_t first_valid = started_after > CAPACITY ? started_after - CAPACITY : 0;
+    if (first_valid > begin)
+      events.erase(events.begin(), events.begin() + std::min(first_valid - begin, events.size()));
+    return events;
+  }
+};
+
+class Registry {
+public:
+  Registry() : _start(std::chrono::steady_clock::now()) {}
+
+  ~Registry() {
+    if (const char *path = std::getenv("DARPARU_TRACE")) {
+      try {
+        write(std::filesystem::path(path));
+      } catch (const std::exception &error) {
+        std::cerr << "Profile: " << error.what() << std::endl;
+      }
+    }
+  }
+
+  std::chrono::steady_clock::time_point start() const { return _start; }
+
+  ThreadBuffer *add_thread() {
+    std::lock_guard lock(_mutex);
+    _threads.push_back(std::make_unique<ThreadBuffer>());
+    _threads.back()->thread_index = _threads.size();
+    return _threads.back().get();
+  }
+
+  void write(std::ostream &stream) {
+    std::lock_guard lock(_mutex);
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    // Microseconds with nanosecond resolution.
+    stream << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto &thread : _threads) {
+      for (const Event &event : thread->events()) {
+        stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+        for (const char *c = event.name; *c; ++c) {
+          if (*c == '"' || *c == '\\')
+            stream << '\\';
+          stream << *c;
+        }
+        stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->thread_index
+               << ",\"ts\":" << static_cast<double>(event.begin) * 1e-3
+               << ",\"dur\":" << static_cast<double>(event.end - event.begin) * 1e-3 << "}";
+        first = false;
+      }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    stream.flags(flags);
+    stream.precision(precision);
+  }
+
+  void write(const std::filesystem::path &path) {
+    std::ofstream file(path);
+    if (!file)
+      throw std::runtime_error("Could not open " + path.string());
+    write(file);
+  }
+
+private:
+  std::chrono::steady_clock::time_point _start;
+  std::mutex _mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> _threads;
+};
+
+Registry &registry() {
+  static Registry registry;
+  return registry;
+}
+
+} // namespace
+
+std::uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry().start())
+      .count();
+}
+
+void record(const char *name, std::uint64_t begin, std::uint64_t end) {
+  // Buffers stay with the registry after their thread exits, so its zones still make it into the trace.
+  thread_local ThreadBuffer *buffer = registry().add_thread();
+  buffer->record({name, begin, end});
+}
+
+void write_chrome_trace(std::ostream &stream) { registry().write(stream); }
+
+void write_chrome_trace(const std::filesystem::path &path) { registry().write(path); }
+
+} // namespace darparu::profile
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+// Scoped CPU profiling zones, recorded per thread without locks and exported as Chrome trace JSON, which
+// chrome://tracing and Perfetto open. Zones only exist in builds with DARPARU_PROFILE defined (bazel build
+// --define=darparu_profile=1), otherwise DARPARU_PROFILE_ZONE compiles to nothing. The trace is written to the path in
+// the DARPARU_TRACE environment variable at exit, or on demand with write_chrome_trace. Each thread keeps only its
+// latest 65536 zones, older ones are overwritten, so long runs hold a bounded amount of memory (1.5 MiB per thread).
+
+namespace darparu::profile {
+
+// Nanoseconds since the first zone of the process.
+std::uint64_t now();
+
+// Appends a finished zone to the calling thread's ring, name must outlive the process (e.g. a string literal).
+void record(const char *name, std::uint64_t begin, std::uint64_t end);
+
+void write_chrome_trace(std::ostream &stream);
+void write_chrome_trace(const std::filesystem::path &path);
+
+class Zone {
+public:
+  explicit Zone(const char *name) : _name(name), _begin(now()) {}
+  ~Zone() { record(_name, _begin, now()); }
+
+  Zone(const Zone &) = delete;
+  Zone &operator=(const Zone &) = delete;
+
+private:
+  const char *_name;
+  std::uint64_t _begin;
+};
+
+} // namespace darparu::profile
+
+#define DARPARU_PROFILE_CONCATENATE_(a, b) a##b
+#define DARPARU_PROFILE_CONCATENATE(a, b) DARPARU_PROFILE_CONCATENATE_(a, b)
+
+#ifdef DARPARU_PROFILE
+#define DARPARU_PROFILE_ZONE(name)                                                                                     \
+  ::darparu::profile::Zone DARPARU_PROFILE_CONCATENATE(darparu_profile_zone_, __LINE__)(name)
+#else
+#define DARPARU_PROFILE_ZONE(name)
+#endif
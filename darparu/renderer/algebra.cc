@@ -1,4 +1,5 @@
 #include "darparu/renderer/algebra.h"
+#include "darparu/renderer/simd_algebra.h"
 #include <array>
 #include <math.h>
 #include <span>
@@ -38,37 +39,12 @@ std::array<float, 16> eye4d() {
 }
 
 std::array<float, 16> multiply_matrices(const std::array<float, 16> &a, const std::array<float, 16> &b) {
-  std::array<float, 16> result;
-
-  std::span A_md(a.data(), 4 * 4);
-  std::span B_md(b.data(), 4 * 4);
-  std::span R_md(result.data(), 4 * 4);
-
-  for (std::size_t i = 0; i < 4; ++i) {
-    for (std::size_t j = 0; j < 4; ++j) {
-      float sum = 0.0f;
-      for (std::size_t k = 0; k < 4; ++k) {
-        sum += A_md[i * 4 + k] * B_md[k * 4 + j];
-      }
-      R_md[i * 4 + j] = sum;
-    }
-  }
-
-  return result;
+  return (Mat4::load(a) * Mat4::load(b)).array();
 }
 
 std::array<float, 4> multiply_matrix(const std::array<float, 16> &a, const std::array<float, 4> &b) {
-  std::array<float, 4> result;
-  auto A_md = std::span(a.data(), 4 * 4);
-  for (std::size_t i = 0; i < 4; ++i) {
-    float sum = A_md[i * 4 + 0] * b[0];
-    for (std::size_t j = 1; j < 4; ++j) {
-      sum += A_md[i * 4 + j] * b[j];
-    }
-    result[i] = sum;
-  }
-  return result;
-};
+  return transform(Mat4::load(a), Vec4::load(b)).array();
+}
 
 std::array<float, 16> translate(const std::array<float, 16> &matrix, const std::array<float, 3> &vector) {
   // Create a 4x4 identity matrix for scaling.
@@ -138,18 +114,7 @@ std::array<float, 16> rotate(const std::array<float, 16> &matrix, const std::arr
 }
 
 std::array<float, 16> transpose(const std::array<float, 16> &matrix) {
-  std::array<float, 16> transposed{};
-
-  // Iterate through all elements
-  for (size_t row = 0; row < 4; ++row) {
-    for (size_t col = 0; col < 4; ++col) {
-      // Original index: row * 4 + col
-      // Transposed index: col * 4 + row
-      transposed[col * 4 + row] = matrix[row * 4 + col];
-    }
-  }
-
-  return transposed;
+  return transpose(Mat4::load(matrix)).array();
 }
 
 std::array<float, 16> look_at(const std::array<float, 3> &eye, const std::array<float, 3> &center,
@@ -236,51 +201,6 @@ std::array<float, 16> perspective(float fov, float aspect, float near, float far
   return transpose(flat_result);
 }
 
-std::array<float, 16> inverse(std::array<float, 16> matrix) {
-  constexpr int n = 4;
-  std::array<float, 16> inv = eye4d();
-  constexpr float threshold = 1e-8;
-
-  for (int i = 0; i < n; i++) {
-    // Find the pivot row for column i.
-    int pivot = i;
-    float max_val = std::abs(matrix[i * n + i]);
-    for (int j = i + 1; j < n; j++) {
-      float val = std::abs(matrix[j * n + i]);
-      if (val > max_val) {
-        max_val = val;
-        pivot = j;
-      }
-    }
-    if (std::abs(matrix[pivot * n + i]) < threshold) {
-      // Matrix is singular; return identity or handle error.
-      return eye4d();
-    }
-    // Swap the current row with the pivot row if needed.
-    if (pivot != i) {
-      for (int j = 0; j < n; j++) {
-        std::swap(matrix[i * n + j], matrix[pivot * n + j]);
-        std::swap(inv[i * n + j], inv[pivot * n + j]);
-      }
-    }
-    // Divide the pivot row by the pivot value.
-    float diag = matrix[i * n + i];
-    for (int j = 0; j < n; j++) {
-      matrix[i * n + j] /= diag;
-      inv[i * n + j] /= diag;
-    }
-    // Eliminate all other rows.
-    for (int k = 0; k < n; k++) {
-      if (k != i) {
-        float factor = matrix[k * n + i];
-        for (int j = 0; j < n; j++) {
-          matrix[k * n + j] -= factor * matrix[i * n + j];
-          inv[k * n + j] -= factor * inv[i * n + j];
-        }
-      }
-    }
-  }
-  return inv;
-}
+std::array<float, 16> inverse(const std::array<float, 16> &matrix) { return inverse(Mat4::load(matrix)).array(); }
 
 } // namespace darparu::renderer
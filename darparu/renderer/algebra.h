@@ -21,6 +21,8 @@ std::array<float, 3> update_orbit_camera_position(float azimuth_radians, float e
 
 std::array<float, 16> eye4d();
 
+// The matrix functions are thin wrappers of the SIMD ones in simd_algebra.h, use those directly to keep matrices in
+// registers across several operations or to transform many vectors.
 std::array<float, 16> multiply_matrices(const std::array<float, 16> &a, const std::array<float, 16> &b);
 
 std::array<float, 4> multiply_matrix(const std::array<float, 16> &a, const std::array<float, 4> &b);
@@ -41,6 +43,8 @@ std::array<float, 16> orthographic(float left, float right, float bottom, float
 
 std::array<float, 16> perspective(float fov, float aspect, float near, float far);
 
-std::array<float, 16> inverse(std::array<float, 16> matrix);
+// Singular and nearly singular matrices give the identity, see SINGULAR_THRESHOLD in simd_algebra.h. The test is
+// relative to the size of the rows, so uniformly scaled matrices are inverted however small the scale.
+std::array<float, 16> inverse(const std::array<float, 16> &matrix);
 
 } // namespace darparu::renderer
@@ -1,30 +1,23 @@
 #include "darparu/renderer/camera_texture.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace darparu::renderer {
-CameraTexture::CameraTexture(int width, int height) : _width(width), _height(height) {
+CameraTexture::CameraTexture(int width, int height, float scale, bool mipmaps)
+    : _width(width), _height(height), _scale(scale), _mipmaps(mipmaps) {
+  if (!(scale > 0.0f && scale <= 1.0f))
+    throw std::invalid_argument("Invalid camera texture scale");
   glGenFramebuffers(1, &_framebuffer);
-  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
-
-  // Create texture
   glGenTextures(1, &rendered_texture);
-  glBindTexture(GL_TEXTURE_2D, rendered_texture);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, _width, _height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-  // Create depth buffer
   glGenRenderbuffers(1, &_depth_render_buffer);
-  glBindRenderbuffer(GL_RENDERBUFFER, _depth_render_buffer);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, _width, _height);
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth_render_buffer);
 
-  // Attach texture
-  glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, rendered_texture, 0);
-  glDrawBuffer(GL_COLOR_ATTACHMENT0);
+  allocate();
 
+  gl_state().bind_framebuffer(GL_FRAMEBUFFER, _framebuffer);
+  glDrawBuffer(GL_COLOR_ATTACHMENT0);
   if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
     throw std::runtime_error("Failed to create camera");
   }
@@ -33,40 +26,75 @@ CameraTexture::CameraTexture(int width, int height) : _width(width), _height(hei
 }
 
 CameraTexture::~CameraTexture() {
-  glDeleteRenderbuffers(1, &_depth_render_buffer);
-  glDeleteFramebuffers(1, &_framebuffer);
-  glDeleteTextures(1, &rendered_texture);
+  gl_state().delete_renderbuffer(_depth_render_buffer);
+  gl_state().delete_framebuffer(_framebuffer);
+  gl_state().delete_texture(rendered_texture);
 }
 
 void CameraTexture::resize(int width, int height) {
   _width = width;
   _height = height;
+  allocate();
+}
 
-  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+void CameraTexture::set_resolution(float scale, bool mipmaps) {
+  if (!(scale > 0.0f && scale <= 1.0f))
+    throw std::invalid_argument("Invalid camera texture scale");
+  _scale = scale;
+  _mipmaps = mipmaps;
+  allocate();
+}
+
+void CameraTexture::allocate() {
+  _texture_width = std::max(1, static_cast<int>(std::lround(_width * _scale)));
+  _texture_height = std::max(1, static_cast<int>(std::lround(_height * _scale)));
 
-  // Resize texture
-  glBindTexture(GL_TEXTURE_2D, rendered_texture);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, _width, _height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  gl_state().bind_framebuffer(GL_FRAMEBUFFER, _framebuffer);
+
+  // Texture, its mip levels are allocated by glGenerateMipmap
+  gl_state().bind_texture(0, GL_TEXTURE_2D, rendered_texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, _texture_width, _texture_height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _scale < 1.0f ? GL_LINEAR : GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-  // Resize depth buffer
+  if (_mipmaps)
+    glGenerateMipmap(GL_TEXTURE_2D);
+  // Drivers store RGB8 as RGBA8, and a full mip chain adds a third.
+  const size_t texels = static_cast<size_t>(_texture_width) * static_cast<size_t>(_texture_height);
+  memory_tracker().track(MemoryKind::texture, rendered_texture, _mipmaps ? texels * 4 * 4 / 3 : texels * 4, this,
+                         "CameraTexture");
+
+  // Depth buffer
   glBindRenderbuffer(GL_RENDERBUFFER, _depth_render_buffer);
-  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, _width, _height);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _texture_width, _texture_height);
+  memory_tracker().track(MemoryKind::renderbuffer, _depth_render_buffer, texels * 4, this, "CameraTexture");
 
-  // Reattach buffers
-  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth_render_buffer);
+  // (Re)attach buffers
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _depth_render_buffer);
   glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, rendered_texture, 0);
 }
 
 void CameraTexture::bind() {
-  glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
-  glViewport(0, 0, _width, _height);
+  gl_state().bind_framebuffer(GL_FRAMEBUFFER, _framebuffer);
+  glViewport(0, 0, _texture_width, _texture_height);
 }
 
-void CameraTexture::unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+void CameraTexture::unbind() { gl_state().bind_framebuffer(GL_FRAMEBUFFER, 0); }
+
+void CameraTexture::generate_mipmaps() {
+  if (!_mipmaps)
+    return;
+  gl_state().bind_texture(0, GL_TEXTURE_2D, rendered_texture);
+  glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void CameraTexture::blit_to(GLuint framebuffer) {
+  gl_state().bind_framebuffer(GL_READ_FRAMEBUFFER, _framebuffer);
+  gl_state().bind_framebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+  glBlitFramebuffer(0, 0, _texture_width, _texture_height, 0, 0, _width, _height,
+                    GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
 
 Texture CameraTexture::texture() { return Texture(rendered_texture); }
 
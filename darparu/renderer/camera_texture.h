@@ -9,19 +9,38 @@ class CameraTexture {
 public:
   GLuint rendered_texture;
 
-  CameraTexture(int width, int height);
+  // The texture is allocated at scale times width by height. With mipmaps it samples with trilinear filtering, and
+  // generate_mipmaps has to be called after each render into it.
+  CameraTexture(int width, int height, float scale = 1.0f, bool mipmaps = false);
   ~CameraTexture();
 
   void resize(int width, int height);
+  void set_resolution(float scale, bool mipmaps);
   void bind();
   void unbind();
+  void generate_mipmaps();
+  // Copies colour and depth, stretched to width by height, to another framebuffer, which needs a 24 bit depth and 8
+  // bit stencil format to match.
+  void blit_to(GLuint framebuffer);
+
+  float scale() const { return _scale; }
+  bool mipmaps() const { return _mipmaps; }
+  GLuint framebuffer() const { return _framebuffer; }
+  int texture_width() const { return _texture_width; }
+  int texture_height() const { return _texture_height; }
 
   Texture texture();
 
 private:
   int _width;
   int _height;
+  float _scale;
+  bool _mipmaps;
+  int _texture_width;
+  int _texture_height;
   GLuint _framebuffer;
   GLuint _depth_render_buffer;
+
+  void allocate();
 };
 } // namespace darparu::renderer
@@ -1,9 +1,10 @@
 #pragma once
 #include "darparu/renderer/renderable.h"
 #include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
 #include <GL/glew.h>
 #include <array>
-#include <vector>
+#include <memory>
 
 namespace darparu::renderer::entities {
 
@@ -18,26 +19,22 @@ public:
   Ball(Ball &&other) = delete;
   Ball &operator=(Ball &&other) = delete;
 
-  void set_view(const std::array<float, 16> &view);
-  void set_view_position(const std::array<float, 3> &position);
-  void set_projection(const std::array<float, 16> &projection);
   void set_model(const std::array<float, 16> &model);
   void set_color(const std::array<float, 3> &color);
-  void set_light_position(const std::array<float, 3> &position);
-  void set_light_color(const std::array<float, 3> &color);
 
   void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
 
 private:
-  Shader _shader;
-  GLuint _vbo;
-  GLuint _vao;
-  GLuint _ebo;
-  size_t _indices;
-
-  GLuint init_vbo(const std::vector<float> &vertices);
-  GLuint init_ebo(const std::vector<unsigned int> &indices);
-  GLuint init_vao(GLuint vbo, GLuint ebo);
+  // The program is shared with other balls, so uniforms are kept here and set at draw time.
+  std::array<float, 16> _model{};
+  std::array<float, 3> _color{};
+  size_t _lod = 0;
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  Uniform<std::array<float, 3>> _color_uniform;
+  std::shared_ptr<StaticMesh> _mesh;
 };
 
 } // namespace darparu::renderer::entities
@@ -0,0 +1,174 @@
+#include "darparu/renderer/entities/ball_batch.h"
+#include "darparu/renderer/entities/ball_mesh.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include "darparu/renderer/resource_cache.h"
+#include "darparu/renderer/shader.h"
+#include "darparu/renderer/shader_context_manager.h"
+#include <GL/glew.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace darparu::renderer::entities {
+
+static_assert(sizeof(BallInstance) == 7 * sizeof(float), "BallInstance must be tightly packed");
+
+BallBatch::BallBatch(BallRendering rendering)
+    : _rendering(rendering),
+      _shader(rendering == BallRendering::mesh
+                  ? resource_cache().shader("darparu/renderer/shaders/simple_instanced.vs",
+                                            "darparu/renderer/shaders/simple_instanced.fs")
+                  : resource_cache().shader("darparu/renderer/shaders/ball_impostor.vs",
+                                            "darparu/renderer/shaders/ball_impostor.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _mesh(rendering == BallRendering::mesh ? ball_mesh() : nullptr), _instance_vbo(0), _vao(0),
+      _instance_capacity(0) {
+  glGenBuffers(1, &_instance_vbo);
+  _vao = init_vao(_instance_vbo);
+}
+
+BallBatch::~BallBatch() {
+  if (_instance_vbo != 0)
+    gl_state().delete_buffer(_instance_vbo);
+  if (_vao != 0)
+    gl_state().delete_vertex_array(_vao);
+  memory_tracker().release_host(this);
+}
+
+GLuint BallBatch::init_vao(GLuint instance_vbo) {
+  GLuint vao;
+  glGenVertexArrays(1, &vao);
+  gl_state().bind_vertex_array(vao);
+
+  // Impostor quads have no vertex attributes, their corners come from gl_VertexID.
+  if (_mesh)
+    _mesh->bind_attributes();
+
+  const GLuint location = instance_location();
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, instance_vbo);
+  glEnableVertexAttribArray(location);
+  glVertexAttribDivisor(location, 1);
+  glEnableVertexAttribArray(location + 1);
+  glVertexAttribDivisor(location + 1, 1);
+  set_instance_attributes(0);
+
+  gl_state().bind_vertex_array(0);
+  return vao;
+}
+
+// The instance attributes follow the mesh's position and normal.
+GLuint BallBatch::instance_location() const { return _mesh ? 2 : 0; }
+
+// Without base instance draws (GL 4.2) a level's instances are selected by offsetting the instance attributes.
+void BallBatch::set_instance_attributes(size_t first_instance) {
+  const size_t offset = first_instance * sizeof(BallInstance);
+  const GLuint location = instance_location();
+  GL_CALL(glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(BallInstance),
+                                reinterpret_cast<void *>(offset + offsetof(BallInstance, center_radius))));
+  GL_CALL(glVertexAttribPointer(location + 1, 3, GL_FLOAT, GL_FALSE, sizeof(BallInstance),
+                                reinterpret_cast<void *>(offset + offsetof(BallInstance, color))));
+}
+
+void BallBatch::set_model(const std::array<float, 16> &model) {
+  _model = model;
+  _dirty = true;
+  mark_dirty();
+}
+
+void BallBatch::set_instances(std::span<const BallInstance> instances) {
+  _instances.assign(instances.begin(), instances.end());
+  _dirty = true;
+  mark_dirty();
+}
+
+void BallBatch::update_levels(const RenderQueue &queue) {
+  // Instances are scaled by the model's (assumed uniform) scale.
+  const float scale = std::sqrt(_model[0] * _model[0] + _model[4] * _model[4] + _model[8] * _model[8]);
+  bool changed = _dirty || _levels.size() != _instances.size();
+  _levels.resize(_instances.size());
+  for (size_t i = 0; i < _instances.size(); ++i) {
+    const auto &center_radius = _instances[i].center_radius;
+    std::array<float, 3> center;
+    for (size_t row = 0; row < 3; ++row)
+      center[row] = _model[row * 4] * center_radius[0] + _model[row * 4 + 1] * center_radius[1] +
+                    _model[row * 4 + 2] * center_radius[2] + _model[row * 4 + 3];
+    const float screen_radius = queue.screen_radius(center, scale * center_radius[3]);
+    const auto level = static_cast<std::uint8_t>(select_ball_lod(screen_radius));
+    changed |= level != _levels[i];
+    _levels[i] = level;
+  }
+  if (!changed)
+    return;
+
+  // Counting sort the instances by level so each level is a contiguous range of the instance buffer.
+  _level_counts.fill(0);
+  for (auto level : _levels)
+    ++_level_counts[level];
+  std::array<size_t, BALL_LOD_LEVELS> next{};
+  for (size_t level = 1; level < BALL_LOD_LEVELS; ++level)
+    next[level] = next[level - 1] + _level_counts[level - 1];
+  _sorted_instances.resize(_instances.size());
+  for (size_t i = 0; i < _instances.size(); ++i)
+    _sorted_instances[next[_levels[i]]++] = _instances[i];
+  upload(_sorted_instances);
+}
+
+void BallBatch::upload(const std::vector<BallInstance> &instances) {
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _instance_vbo);
+  const size_t bytes = instances.size() * sizeof(BallInstance);
+  if (instances.size() > _instance_capacity) {
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, bytes, instances.data(), GL_DYNAMIC_DRAW));
+    _instance_capacity = instances.size();
+    memory_tracker().track(MemoryKind::buffer, _instance_vbo, bytes, this, "BallBatch");
+    memory_tracker().track_host(this, "BallBatch", "instances", _instances);
+    memory_tracker().track_host(this, "BallBatch", "sorted instances", _sorted_instances);
+    memory_tracker().track_host(this, "BallBatch", "levels", _levels);
+  } else {
+    // Orphan the old storage so the update does not wait on draws still reading it.
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, _instance_capacity * sizeof(BallInstance), nullptr, GL_DYNAMIC_DRAW));
+    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances.data()));
+  }
+  _dirty = false;
+}
+
+void BallBatch::draw() {
+  if (_instances.empty())
+    return;
+  ShaderContextManager context(*_shader);
+  _shader->set(_model_uniform, _model);
+  gl_state().bind_vertex_array(_vao);
+  if (_rendering == BallRendering::impostor) {
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _instances.size());
+    gl_state().count_draw(GL_TRIANGLE_STRIP, 4, _instances.size());
+    return;
+  }
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _instance_vbo);
+  const auto &lods = ball_lods();
+  size_t first_instance = 0;
+  for (size_t level = 0; level < BALL_LOD_LEVELS; ++level) {
+    if (_level_counts[level] == 0)
+      continue;
+    set_instance_attributes(first_instance);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lods[level].index_count, GL_UNSIGNED_INT,
+                                      reinterpret_cast<void *>(lods[level].first_index * sizeof(unsigned int)),
+                                      _level_counts[level], lods[level].base_vertex);
+    gl_state().count_draw(GL_TRIANGLES, lods[level].index_count, _level_counts[level]);
+    first_instance += _level_counts[level];
+  }
+}
+
+void BallBatch::submit(RenderQueue &queue, RenderPass pass) {
+  if (_rendering == BallRendering::impostor) {
+    if (_dirty)
+      upload(_instances);
+  } else if (queue.frame() != _levels_frame) {
+    update_levels(queue);
+    _levels_frame = queue.frame();
+  }
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _vao, queue.depth(_model), this);
+}
+
+} // namespace darparu::renderer::entities
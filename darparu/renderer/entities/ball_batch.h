@@ -0,0 +1,72 @@
+#pragma once
+#include "darparu/renderer/entities/ball_mesh.h"
+#include "darparu/renderer/renderable.h"
+#include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace darparu::renderer::entities {
+
+struct BallInstance {
+  // x, y, z and radius.
+  std::array<float, 4> center_radius;
+  std::array<float, 3> color;
+};
+
+// mesh: icosphere levels of detail, one instanced draw per level in use.
+// impostor: one camera facing quad per ball, ray-cast per pixel into an exact sphere writing its own depth.
+enum class BallRendering { mesh, impostor };
+
+// Draws any number of balls sharing one sphere mesh, or impostor quad, with instanced draw calls.
+class BallBatch : public Renderable {
+public:
+  BallBatch(BallRendering rendering = BallRendering::mesh);
+  ~BallBatch();
+
+  BallBatch(const BallBatch &) = delete;
+  BallBatch &operator=(const BallBatch &) = delete;
+
+  BallBatch(BallBatch &&other) = delete;
+  BallBatch &operator=(BallBatch &&other) = delete;
+
+  // Applied to every instance after its centre and radius.
+  void set_model(const std::array<float, 16> &model);
+  // Replaces all instances. They are uploaded at the next submit, for meshes sorted by level of detail.
+  void set_instances(std::span<const BallInstance> instances);
+
+  void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
+
+private:
+  std::array<float, 16> _model{};
+  BallRendering _rendering;
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  // Null for impostors.
+  std::shared_ptr<StaticMesh> _mesh;
+  GLuint _instance_vbo;
+  GLuint _vao;
+  size_t _instance_capacity;
+
+  std::vector<BallInstance> _instances;
+  std::vector<BallInstance> _sorted_instances;
+  std::vector<std::uint8_t> _levels;
+  std::array<size_t, BALL_LOD_LEVELS> _level_counts{};
+  std::uint64_t _levels_frame = ~std::uint64_t(0);
+  bool _dirty = true;
+
+  GLuint init_vao(GLuint instance_vbo);
+  GLuint instance_location() const;
+  void set_instance_attributes(size_t first_instance);
+  // Selects each instance's level of detail from its screen radius and uploads the instances grouped by level.
+  void update_levels(const RenderQueue &queue);
+  void upload(const std::vector<BallInstance> &instances);
+};
+
+} // namespace darparu::renderer::entities
@@ -0,0 +1,101 @@
+#include "darparu/renderer/entities/ball_mesh.h"
+#include "darparu/renderer/resource_cache.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace darparu::renderer::entities {
+
+// Smallest on screen radius in pixels of each level, a subdivision roughly halves the edge length.
+static constexpr std::array<float, BALL_LOD_LEVELS - 1> LOD_SCREEN_RADII = {64.0f, 16.0f, 4.0f};
+
+static void add_vertex(std::vector<float> &vertices, std::array<float, 3> position) {
+  const float length = std::sqrt(position[0] * position[0] + position[1] * position[1] + position[2] * position[2]);
+  for (size_t i = 0; i < 3; ++i)
+    position[i] /= length;
+  // On a unit sphere the normal is the position.
+  vertices.insert(vertices.end(), {position[0], position[1], position[2], position[0], position[1], position[2]});
+}
+
+static void add_icosphere(std::vector<float> &vertices, std::vector<unsigned int> &indices, int subdivisions) {
+  const size_t base_vertex = vertices.size() / 6;
+  const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+  const std::array<std::array<float, 3>, 12> corners = {{{-1, t, 0},
+                                                         {1, t, 0},
+                                                         {-1, -t, 0},
+                                                         {1, -t, 0},
+                                                         {0, -1, t},
+                                                         {0, 1, t},
+                                                         {0, -1, -t},
+                                                         {0, 1, -t},
+                                                         {t, 0, -1},
+                                                         {t, 0, 1},
+                                                         {-t, 0, -1},
+                                                         {-t, 0, 1}}};
+  for (const auto &corner : corners)
+    add_vertex(vertices, corner);
+
+  std::vector<unsigned int> faces = {
+      0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, // Around the first corner
+      1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8, // Adjacent band
+      3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,     // Around the opposite corner
+      4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1,   // Its adjacent band
+  };
+  for (int level = 0; level < subdivisions; ++level) {
+    // Edges shared by two faces get one midpoint.
+    std::unordered_map<std::uint64_t, unsigned int> midpoints;
+    auto midpoint = [&](unsigned int a, unsigned int b) {
+      const std::uint64_t key = static_cast<std::uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+      auto [it, inserted] = midpoints.try_emplace(key, vertices.size() / 6 - base_vertex);
+      if (inserted) {
+        const float *pa = &vertices[(base_vertex + a) * 6];
+        const float *pb = &vertices[(base_vertex + b) * 6];
+        add_vertex(vertices, {pa[0] + pb[0], pa[1] + pb[1], pa[2] + pb[2]});
+      }
+      return it->second;
+    };
+    std::vector<unsigned int> subdivided;
+    subdivided.reserve(faces.size() * 4);
+    for (size_t i = 0; i < faces.size(); i += 3) {
+      const unsigned int a = faces[i], b = faces[i + 1], c = faces[i + 2];
+      const unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+      subdivided.insert(subdivided.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+    }
+    faces = std::move(subdivided);
+  }
+  indices.insert(indices.end(), faces.begin(), faces.end());
+}
+
+BallData create_ball_mesh() {
+  BallData data;
+  for (size_t level = 0; level < BALL_LOD_LEVELS; ++level) {
+    const GLint base_vertex = data.vertices.size() / 6;
+    const GLsizei first_index = data.indices.size();
+    add_icosphere(data.vertices, data.indices, BALL_LOD_LEVELS - 1 - level);
+    data.lods[level] = {first_index, static_cast<GLsizei>(data.indices.size()) - first_index, base_vertex};
+  }
+  return data;
+}
+
+size_t select_ball_lod(float screen_radius) {
+  size_t level = 0;
+  while (level < LOD_SCREEN_RADII.size() && screen_radius < LOD_SCREEN_RADII[level])
+    ++level;
+  return level;
+}
+
+std::shared_ptr<StaticMesh> ball_mesh() {
+  return resource_cache().mesh("ball", [] {
+    BallData mesh_data = create_ball_mesh();
+    return std::make_shared<StaticMesh>(mesh_data.vertices, mesh_data.indices, std::vector<GLint>{3, 3}, "ball mesh");
+  });
+}
+
+const BallLods &ball_lods() {
+  // create_ball_mesh() is deterministic, so building it again on the CPU gives the ranges of the uploaded mesh without
+  // depending on whether it is alive.
+  static const BallLods lods = create_ball_mesh().lods;
+  return lods;
+}
+
+} // namespace darparu::renderer::entities
@@ -0,0 +1,41 @@
+#pragma once
+#include "darparu/renderer/static_mesh.h"
+#include <GL/glew.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace darparu::renderer::entities {
+
+// Level 0 is the most detailed.
+constexpr size_t BALL_LOD_LEVELS = 4;
+
+// An index range of the shared ball mesh, indices are relative to base_vertex.
+struct BallLod {
+  GLsizei first_index;
+  GLsizei index_count;
+  GLint base_vertex;
+};
+
+using BallLods = std::array<BallLod, BALL_LOD_LEVELS>;
+
+struct BallData {
+  // Interleaved x, y, z, nx, ny, nz floats per vertex.
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  BallLods lods;
+};
+
+// Unit icospheres centred at the origin, one per level of detail, in one vertex and one index buffer. Level 0 is
+// subdivided BALL_LOD_LEVELS - 1 times (1280 triangles), the last level is the icosahedron itself.
+BallData create_ball_mesh();
+
+// The level of detail for a ball covering screen_radius pixels.
+size_t select_ball_lod(float screen_radius);
+
+// The ball mesh shared through the resource cache.
+std::shared_ptr<StaticMesh> ball_mesh();
+// The levels of detail of the shared ball mesh, computed once without uploading anything.
+const BallLods &ball_lods();
+
+} // namespace darparu::renderer::entities
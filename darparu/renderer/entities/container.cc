@@ -1,4 +1,5 @@
 #include "darparu/renderer/entities/container.h"
+#include "darparu/renderer/resource_cache.h"
 #include "darparu/renderer/shader.h"
 #include "darparu/renderer/shader_context_manager.h"
 
@@ -11,11 +12,6 @@
 
 namespace darparu::renderer::entities {
 
-struct MeshData {
-  std::vector<float> vertices;
-  std::vector<unsigned int> indices;
-};
-
 struct CubeData {
   std::vector<float> vertices;
   std::vector<float> normals;
@@ -64,10 +60,10 @@ CubeData cube_vertices_normals_and_indices() {
           }};
 }
 
-MeshData create_mesh(float size, float wall_thickness) {
+Geometry container_geometry(float size, float wall_thickness) {
   constexpr float height_scale = 1.25f;
   CubeData cube = cube_vertices_normals_and_indices();
-  MeshData mesh;
+  Geometry mesh;
 
   // Add the floor plane:
   mesh.vertices = {0, 0, 0, 0, size, 0, size, 0, 0, 0, size, 0, size, 0, size, 0, size, 0, 0, 0, size, 0, size, 0};
@@ -109,115 +105,37 @@ MeshData create_mesh(float size, float wall_thickness) {
 }
 
 Container::Container(float wall_size, float wall_thickness)
-    : _shader(read_file("darparu/renderer/shaders/simple.vs"), read_file("darparu/renderer/shaders/simple.fs")),
-      _vbo(0), _vao(0), _ebo(0) {
-  MeshData mesh_data = create_mesh(wall_size, wall_thickness);
-
-  _vbo = init_vbo(mesh_data.vertices);
-  _ebo = init_ebo(mesh_data.indices);
-  _vao = init_vao(_vbo, _ebo, mesh_data.vertices);
-
-  glBindVertexArray(0);
-}
-
-Container::~Container() {
-  glBindVertexArray(0);
-  if (_vbo != 0)
-    glDeleteBuffers(1, &_vbo);
-  if (_ebo != 0)
-    glDeleteBuffers(1, &_ebo);
-  if (_vao != 0)
-    glDeleteVertexArrays(1, &_vao);
-}
-
-GLuint Container::init_vbo(const std::vector<float> &vertices) {
-  GLuint vbo;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-  return vbo;
-}
-
-GLuint Container::init_ebo(const std::vector<unsigned int> &indices) {
-  GLuint ebo;
-  glGenBuffers(1, &ebo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-  return ebo;
-}
-
-GLuint Container::init_vao(GLuint vbo, GLuint ebo, const std::vector<float> &vertices) {
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(0));
-  glEnableVertexAttribArray(0);
-
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
-
-  glBindVertexArray(0);
-  return vao;
-}
-
-void Container::set_view(const std::array<float, 16> &view) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("view", view);
-  }
-}
+    : _shader(resource_cache().shader("darparu/renderer/shaders/simple.vs", "darparu/renderer/shaders/simple.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _color_uniform(_shader->uniform<std::array<float, 3>>("objectColor")),
+      _mesh(resource_cache().mesh("container:" + std::to_string(wall_size) + ":" + std::to_string(wall_thickness), [&] {
+        Geometry mesh_data = container_geometry(wall_size, wall_thickness);
+        return std::make_shared<StaticMesh>(mesh_data.vertices, mesh_data.indices, std::vector<GLint>{3, 3},
+                                            "container mesh");
+      })) {}
 
-void Container::set_view_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("viewPos", position);
-  }
-}
-
-void Container::set_projection(const std::array<float, 16> &projection) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("projection", projection);
-  }
-}
+Container::~Container() {}
 
 void Container::set_model(const std::array<float, 16> &model) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("model", model);
-  }
+  _model = model;
+  mark_dirty();
 }
 
 void Container::set_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("objectColor", color);
-  }
-}
-
-void Container::set_light_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("lightPos", position);
-  }
+  _color = color;
+  mark_dirty();
 }
 
-void Container::set_light_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
+void Container::draw() {
+  ShaderContextManager context(*_shader);
   {
-    _shader.set_uniform_vector("lightColor", color);
+    _shader->set(_model_uniform, _model);
+    _shader->set(_color_uniform, _color);
+    _mesh->draw();
   }
 }
 
-void Container::draw() {
-  ShaderContextManager context(_shader);
-  {
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, 150, GL_UNSIGNED_INT, nullptr);
-  }
+void Container::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _mesh->vertex_array(), queue.depth(_model), this);
 }
 } // namespace darparu::renderer::entities
\ No newline at end of file
@@ -1,36 +1,36 @@
 #pragma once
+#include "darparu/renderer/entities/geometry.h"
 #include "darparu/renderer/renderable.h"
 #include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
 #include <GL/glew.h>
 #include <array>
-#include <vector>
+#include <memory>
 
 namespace darparu::renderer::entities {
 
+// A floor of wall_size by wall_size centred at the origin, walled in on all four sides.
+Geometry container_geometry(float wall_size, float wall_thickness);
+
 class Container : public Renderable {
 public:
   Container(float wall_size, float wall_thickness);
   ~Container();
 
-  void set_view(const std::array<float, 16> &view);
-  void set_view_position(const std::array<float, 3> &position);
-  void set_projection(const std::array<float, 16> &projection);
   void set_model(const std::array<float, 16> &model);
   void set_color(const std::array<float, 3> &color);
-  void set_light_position(const std::array<float, 3> &position);
-  void set_light_color(const std::array<float, 3> &color);
 
   void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
 
 private:
-  Shader _shader;
-  GLuint _vbo;
-  GLuint _vao;
-  GLuint _ebo;
-
-  GLuint init_vbo(const std::vector<float> &vertices);
-  GLuint init_ebo(const std::vector<unsigned int> &indices);
-  GLuint init_vao(GLuint vbo, GLuint ebo, const std::vector<float> &vertices);
+  std::array<float, 16> _model{};
+  std::array<float, 3> _color{};
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  Uniform<std::array<float, 3>> _color_uniform;
+  std::shared_ptr<StaticMesh> _mesh;
 };
 
 } // namespace darparu::renderer::entities
@@ -0,0 +1,12 @@
+#pragma once
+#include <vector>
+
+namespace darparu::renderer::entities {
+
+// An indexed triangle mesh of interleaved x, y, z, nx, ny, nz floats per vertex.
+struct Geometry {
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+};
+
+} // namespace darparu::renderer::entities
@@ -1,127 +1,82 @@
 #include "darparu/renderer/entities/light.h"
+#include "darparu/renderer/resource_cache.h"
 #include "darparu/renderer/shader.h"
 #include "darparu/renderer/shader_context_manager.h"
 
 #include <GL/glew.h>
 
-#include <string>
+#include <vector>
 
 namespace darparu::renderer::entities {
-Light::Light()
-    : _shader(read_file("darparu/renderer/shaders/light_cube.vs"), read_file("darparu/renderer/shaders/light_cube.fs")),
-      _vbo(0), _vao(0), _ebo(0) {
-  std::array<float, 72> vertices = {
+
+Geometry light_geometry() {
+  // Corners of each face, counter clockwise seen from outside, followed by the face normal.
+  static constexpr std::array<std::array<float, 15>, 6> faces = {{
       // Front Face
-      -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, 0.5,
+      {-0.5, -0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.0, 0.0, 1.0},
       // Back Face
-      0.5, -0.5, -0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5,
+      {0.5, -0.5, -0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, 0.0, 0.0, -1.0},
       // Top Face
-      -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, -0.5, 0.5, -0.5,
+      {-0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, -0.5, 0.5, -0.5, 0.0, 1.0, 0.0},
       // Bottom Face
-      -0.5, -0.5, -0.5, 0.5, -0.5, -0.5, 0.5, -0.5, 0.5, -0.5, -0.5, 0.5,
+      {-0.5, -0.5, -0.5, 0.5, -0.5, -0.5, 0.5, -0.5, 0.5, -0.5, -0.5, 0.5, 0.0, -1.0, 0.0},
       // Right Face
-      0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.5,
+      {0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 1.0, 0.0, 0.0},
       // Left Face
-      -0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5,
-      //
-  };
-
-  std::array<unsigned int, 36> indices = {
-      // #Front Face
-      0, 1, 2, 2, 3, 0,
-      // #Back Face
-      4, 5, 6, 6, 7, 4,
-      // #Top Face
-      8, 9, 10, 10, 11, 8,
-      // #Bottom Face
-      12, 13, 14, 14, 15, 12,
-      // #Right Face
-      16, 17, 18, 18, 19, 16,
-      // #Left Face
-      20, 21, 22, 22, 23, 20,
-      //
-  };
-
-  _vbo = init_vbo(vertices);
-  _ebo = init_ebo(indices);
-  _vao = init_vao(_vbo, _ebo, vertices);
-
-  glBindVertexArray(0);
-}
-
-Light::~Light() {
-  if (_vbo != 0)
-    glDeleteBuffers(1, &_vbo);
-  if (_ebo != 0)
-    glDeleteBuffers(1, &_ebo);
-  if (_vao != 0)
-    glDeleteVertexArrays(1, &_vao);
-}
-
-GLuint Light::init_vbo(const std::array<float, 72> &vertices) {
-  GLuint vbo;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-  return vbo;
-}
-
-GLuint Light::init_ebo(const std::array<unsigned int, 36> &indices) {
-  GLuint ebo;
-  glGenBuffers(1, &ebo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-  return ebo;
+      {-0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, -1.0, 0.0, 0.0},
+  }};
+
+  Geometry geometry;
+  geometry.vertices.reserve(faces.size() * 4 * 6);
+  geometry.indices.reserve(faces.size() * 6);
+  for (const auto &face : faces) {
+    unsigned int base = geometry.vertices.size() / 6;
+    for (size_t corner = 0; corner < 4; ++corner) {
+      geometry.vertices.insert(geometry.vertices.end(), &face[3 * corner], &face[3 * corner + 3]);
+      geometry.vertices.insert(geometry.vertices.end(), &face[12], &face[15]);
+    }
+    for (unsigned int index : {0u, 1u, 2u, 2u, 3u, 0u})
+      geometry.indices.push_back(base + index);
+  }
+  return geometry;
 }
 
-GLuint Light::init_vao(GLuint vbo, GLuint ebo, const std::array<float, 72> &vertices) {
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void *>(0));
-  glEnableVertexAttribArray(0);
-
-  glBindVertexArray(0);
-  return vao;
+static std::shared_ptr<StaticMesh> light_cube_mesh() {
+  return resource_cache().mesh("light_cube", [] {
+    Geometry geometry = light_geometry();
+    return std::make_shared<StaticMesh>(geometry.vertices, geometry.indices, std::vector<GLint>{3, 3},
+                                        "light cube mesh");
+  });
 }
 
-void Light::set_view(const std::array<float, 16> &view) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("view", view);
-  }
-}
+Light::Light()
+    : _shader(resource_cache().shader("darparu/renderer/shaders/light_cube.vs",
+                                      "darparu/renderer/shaders/light_cube.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _color_uniform(_shader->uniform<std::array<float, 3>>("objectColor")), _mesh(light_cube_mesh()) {}
 
-void Light::set_projection(const std::array<float, 16> &projection) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("projection", projection);
-  }
-}
+Light::~Light() {}
 
 void Light::set_model(const std::array<float, 16> &model) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("model", model);
-  }
+  _model = model;
+  mark_dirty();
 }
 
 void Light::set_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("objectColor", color);
-  }
+  _color = color;
+  mark_dirty();
 }
 
 void Light::draw() {
-  ShaderContextManager context(_shader);
+  ShaderContextManager context(*_shader);
   {
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+    _shader->set(_model_uniform, _model);
+    _shader->set(_color_uniform, _color);
+    _mesh->draw();
   }
 }
+
+void Light::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _mesh->vertex_array(), queue.depth(_model), this);
+}
 } // namespace darparu::renderer::entities
\ No newline at end of file
@@ -1,32 +1,36 @@
 #pragma once
+#include "darparu/renderer/entities/geometry.h"
 #include "darparu/renderer/renderable.h"
 #include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
 #include <GL/glew.h>
 #include <array>
+#include <memory>
 
 namespace darparu::renderer::entities {
 
+// A unit cube centred at the origin.
+Geometry light_geometry();
+
 class Light : public Renderable {
 public:
   Light();
   ~Light();
 
-  void set_view(const std::array<float, 16> &view);
-  void set_projection(const std::array<float, 16> &projection);
   void set_model(const std::array<float, 16> &model);
   void set_color(const std::array<float, 3> &color);
 
   void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
 
 private:
-  Shader _shader;
-  GLuint _vbo;
-  GLuint _vao;
-  GLuint _ebo;
-
-  GLuint init_vbo(const std::array<float, 72> &vertices);
-  GLuint init_ebo(const std::array<unsigned int, 36> &indices);
-  GLuint init_vao(GLuint vbo, GLuint ebo, const std::array<float, 72> &vertices);
+  std::array<float, 16> _model{};
+  std::array<float, 3> _color{};
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  Uniform<std::array<float, 3>> _color_uniform;
+  std::shared_ptr<StaticMesh> _mesh;
 };
 
 } // namespace darparu::renderer::entities
@@ -1,4 +1,5 @@
 #include "darparu/renderer/entities/mesh_2d.h"
+#include "darparu/renderer/resource_cache.h"
 #include "darparu/renderer/shader.h"
 #include "darparu/renderer/shader_context_manager.h"
 
@@ -33,89 +34,28 @@ std::vector<float> interleave_vertices_and_colors(const std::vector<float> &vert
 }
 
 Mesh2d::Mesh2d(std::vector<float> vertices, std::vector<unsigned int> indices, std::vector<float> colors)
-    : _shader(read_file("darparu/renderer/shaders/simple_2d.vs"), read_file("darparu/renderer/shaders/simple_2d.fs")),
-      _vbo(0), _vao(0), _ebo(0), _num_indices(indices.size()) {
+    : _shader(
+          resource_cache().shader("darparu/renderer/shaders/simple_2d.vs", "darparu/renderer/shaders/simple_2d.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _mesh(std::make_shared<StaticMesh>(interleave_vertices_and_colors(vertices, colors), indices,
+                                         std::vector<GLint>{2, 3}, "Mesh2d")) {}
 
-  auto vertices_and_colors = interleave_vertices_and_colors(vertices, colors);
-
-  _vbo = init_vbo(vertices_and_colors);
-  _ebo = init_ebo(indices);
-  _vao = init_vao(_vbo, _ebo, vertices_and_colors);
-
-  glBindVertexArray(0);
-}
-
-Mesh2d::~Mesh2d() {
-  glBindVertexArray(0);
-  if (_vbo != 0)
-    glDeleteBuffers(1, &_vbo);
-  if (_ebo != 0)
-    glDeleteBuffers(1, &_ebo);
-  if (_vao != 0)
-    glDeleteVertexArrays(1, &_vao);
-}
-
-GLuint Mesh2d::init_vbo(const std::vector<float> &vertices) {
-  GLuint vbo;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-  return vbo;
-}
-
-GLuint Mesh2d::init_ebo(const std::vector<unsigned int> &indices) {
-  GLuint ebo;
-  glGenBuffers(1, &ebo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-  return ebo;
-}
-
-GLuint Mesh2d::init_vao(GLuint vbo, GLuint ebo, const std::vector<float> &vertices) {
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-  // Vertices are 2D (x, y) and colors are 3D (r, g, b)
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(0));
-  glEnableVertexAttribArray(0);
-
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(2 * sizeof(float)));
-  glEnableVertexAttribArray(1);
-
-  glBindVertexArray(0);
-  return vao;
-}
-
-void Mesh2d::set_view(const std::array<float, 16> &view) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("view", view);
-  }
-}
-
-void Mesh2d::set_projection(const std::array<float, 16> &projection) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("projection", projection);
-  }
-}
+Mesh2d::~Mesh2d() {}
 
 void Mesh2d::set_model(const std::array<float, 16> &model) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("model", model);
-  }
+  _model = model;
+  mark_dirty();
 }
 
 void Mesh2d::draw() {
-  ShaderContextManager context(_shader);
+  ShaderContextManager context(*_shader);
   {
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, _num_indices, GL_UNSIGNED_INT, nullptr);
+    _shader->set(_model_uniform, _model);
+    _mesh->draw();
   }
 }
+
+void Mesh2d::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _mesh->vertex_array(), queue.depth(_model), this);
+}
 } // namespace darparu::renderer::entities
\ No newline at end of file
@@ -1,33 +1,33 @@
 #pragma once
 #include "darparu/renderer/renderable.h"
 #include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
 #include <GL/glew.h>
 #include <array>
+#include <memory>
 #include <vector>
 
 namespace darparu::renderer::entities {
 
+// Interleaves x, y vertices with r, g, b colors into x, y, r, g, b vertices.
+std::vector<float> interleave_vertices_and_colors(const std::vector<float> &vertices, const std::vector<float> &colors);
+
 class Mesh2d : public Renderable {
 public:
   Mesh2d(std::vector<float> vertices, std::vector<unsigned int> indices, std::vector<float> colors);
   ~Mesh2d();
 
-  void set_view(const std::array<float, 16> &view);
-  void set_projection(const std::array<float, 16> &projection);
   void set_model(const std::array<float, 16> &model);
 
   void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
 
 private:
-  Shader _shader;
-  GLuint _vbo;
-  GLuint _vao;
-  GLuint _ebo;
-  const size_t _num_indices;
-
-  GLuint init_vbo(const std::vector<float> &vertices);
-  GLuint init_ebo(const std::vector<unsigned int> &indices);
-  GLuint init_vao(GLuint vbo, GLuint ebo, const std::vector<float> &vertices);
+  std::array<float, 16> _model{};
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  std::shared_ptr<StaticMesh> _mesh;
 };
 
 } // namespace darparu::renderer::entities
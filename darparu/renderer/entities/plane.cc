@@ -1,23 +1,17 @@
 #include "darparu/renderer/entities/plane.h"
+#include "darparu/renderer/resource_cache.h"
 #include "darparu/renderer/shader.h"
 #include "darparu/renderer/shader_context_manager.h"
 
 #include <GL/glew.h>
 
 #include <array>
-#include <iostream>
-#include <string>
 #include <vector>
 
 namespace darparu::renderer::entities {
 
-struct MeshData {
-  std::vector<float> vertices;
-  std::vector<unsigned int> indices;
-};
-
-MeshData create_mesh() {
-  MeshData mesh;
+Geometry plane_geometry() {
+  Geometry mesh;
   mesh.vertices = {0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 0};
   mesh.indices = {2, 1, 0, 0, 3, 2};
   for (size_t i = 0; i < mesh.vertices.size(); i += 6) {
@@ -27,124 +21,48 @@ MeshData create_mesh() {
   return mesh;
 }
 
-Plane::Plane()
-    : _shader(read_file("darparu/renderer/shaders/simple_with_normal_matrix.vs"),
-              read_file("darparu/renderer/shaders/simple_with_normal_matrix.fs")),
-      _vbo(0), _vao(0), _ebo(0) {
-  MeshData mesh_data = create_mesh();
-
-  _vbo = init_vbo(mesh_data.vertices);
-  _ebo = init_ebo(mesh_data.indices);
-  _vao = init_vao(_vbo, _ebo, mesh_data.vertices);
-
-  glBindVertexArray(0);
-}
-
-Plane::~Plane() {
-  glBindVertexArray(0);
-  if (_vbo != 0)
-    glDeleteBuffers(1, &_vbo);
-  if (_ebo != 0)
-    glDeleteBuffers(1, &_ebo);
-  if (_vao != 0)
-    glDeleteVertexArrays(1, &_vao);
+static std::shared_ptr<StaticMesh> plane_mesh() {
+  return resource_cache().mesh("plane", [] {
+    Geometry mesh_data = plane_geometry();
+    return std::make_shared<StaticMesh>(mesh_data.vertices, mesh_data.indices, std::vector<GLint>{3, 3}, "plane mesh");
+  });
 }
 
-GLuint Plane::init_vbo(const std::vector<float> &vertices) {
-  GLuint vbo;
-  glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-  glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-  return vbo;
-}
-
-GLuint Plane::init_ebo(const std::vector<unsigned int> &indices) {
-  GLuint ebo;
-  glGenBuffers(1, &ebo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-  return ebo;
-}
-
-GLuint Plane::init_vao(GLuint vbo, GLuint ebo, const std::vector<float> &vertices) {
-  GLuint vao;
-  glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(0));
-  glEnableVertexAttribArray(0);
-
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
-
-  glBindVertexArray(0);
-  return vao;
-}
-
-void Plane::set_view(const std::array<float, 16> &view) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("view", view);
-  }
-}
-
-void Plane::set_view_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("viewPos", position);
-  }
-}
+Plane::Plane()
+    : _shader(resource_cache().shader("darparu/renderer/shaders/simple_with_normal_matrix.vs",
+                                      "darparu/renderer/shaders/simple_with_normal_matrix.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _color_uniform(_shader->uniform<std::array<float, 3>>("objectColor")),
+      _normal_matrix_uniform(_shader->uniform<std::array<float, 16>>("normalMatrix")), _mesh(plane_mesh()) {}
 
-void Plane::set_projection(const std::array<float, 16> &projection) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("projection", projection);
-  }
-}
+Plane::~Plane() {}
 
 void Plane::set_model(const std::array<float, 16> &model) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("model", model);
-  }
+  _model = model;
+  mark_dirty();
 }
 
 void Plane::set_normal_matrix(const std::array<float, 16> &normal_matrix) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_matrix("normalMatrix", normal_matrix);
-  }
-};
-
-void Plane::set_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("objectColor", color);
-  }
+  _normal_matrix = normal_matrix;
+  mark_dirty();
 }
 
-void Plane::set_light_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  {
-    _shader.set_uniform_vector("lightPos", position);
-  }
+void Plane::set_color(const std::array<float, 3> &color) {
+  _color = color;
+  mark_dirty();
 }
 
-void Plane::set_light_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
+void Plane::draw() {
+  ShaderContextManager context(*_shader);
   {
-    _shader.set_uniform_vector("lightColor", color);
+    _shader->set(_model_uniform, _model);
+    _shader->set(_color_uniform, _color);
+    _shader->set(_normal_matrix_uniform, _normal_matrix);
+    _mesh->draw();
   }
 }
 
-void Plane::draw() {
-  ShaderContextManager context(_shader);
-  {
-    glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, 150, GL_UNSIGNED_INT, nullptr);
-  }
+void Plane::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _mesh->vertex_array(), queue.depth(_model), this);
 }
 } // namespace darparu::renderer::entities
\ No newline at end of file
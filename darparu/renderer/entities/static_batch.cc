@@ -0,0 +1,84 @@
+#include "darparu/renderer/entities/static_batch.h"
+#include "darparu/renderer/algebra.h"
+#include "darparu/renderer/memory_tracker.h"
+#include "darparu/renderer/resource_cache.h"
+#include "darparu/renderer/shader.h"
+#include "darparu/renderer/shader_context_manager.h"
+#include "darparu/renderer/simd_algebra.h"
+
+#include <GL/glew.h>
+
+#include <stdexcept>
+
+namespace darparu::renderer::entities {
+
+StaticBatch::StaticBatch()
+    : _shader(resource_cache().shader("darparu/renderer/shaders/static_batch.vs",
+                                      "darparu/renderer/shaders/static_batch.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")) {}
+
+StaticBatch::~StaticBatch() { memory_tracker().release_host(this); }
+
+void StaticBatch::add(const Geometry &geometry, const std::array<float, 16> &model, const std::array<float, 3> &color,
+                      bool emissive) {
+  if (_mesh)
+    throw std::runtime_error("Static batch is already built");
+  if (geometry.vertices.size() % 6 != 0)
+    throw std::invalid_argument("Invalid geometry vertices size");
+
+  // Normals go through the inverse transpose so they stay perpendicular under non-uniform scaling. Both matrices are
+  // kept transposed for transform_transposed, so the transpose of the inverse transpose is just the inverse.
+  const Mat4 model_matrix = Mat4::load(model);
+  const Mat4 position_transposed = transpose(model_matrix);
+  const Mat4 normal_transposed = inverse(model_matrix);
+  const unsigned int base = _vertices.size() / VERTEX_SIZE;
+  _vertices.reserve(_vertices.size() + geometry.vertices.size() / 6 * VERTEX_SIZE);
+  for (size_t i = 0; i < geometry.vertices.size(); i += 6) {
+    const float *vertex = geometry.vertices.data() + i;
+    const auto position =
+        transform_transposed(position_transposed, Vec4::load({vertex[0], vertex[1], vertex[2], 1.0f})).array();
+    const auto normal =
+        transform_transposed(normal_transposed, Vec4::load({vertex[3], vertex[4], vertex[5], 0.0f})).array();
+    const auto unit_normal = normalize({normal[0], normal[1], normal[2]});
+    _vertices.insert(_vertices.end(), {position[0], position[1], position[2], unit_normal[0], unit_normal[1],
+                                       unit_normal[2], color[0], color[1], color[2], emissive ? 1.0f : 0.0f});
+  }
+  _indices.reserve(_indices.size() + geometry.indices.size());
+  for (unsigned int index : geometry.indices)
+    _indices.push_back(base + index);
+  memory_tracker().track_host(this, "StaticBatch", "vertices", _vertices);
+  memory_tracker().track_host(this, "StaticBatch", "indices", _indices);
+}
+
+void StaticBatch::build() {
+  if (_mesh)
+    throw std::runtime_error("Static batch is already built");
+  _mesh = std::make_unique<StaticMesh>(_vertices, _indices, std::vector<GLint>{3, 3, 3, 1}, "StaticBatch");
+  _vertices = {};
+  _indices = {};
+  memory_tracker().release_host(this);
+  mark_dirty();
+}
+
+void StaticBatch::set_model(const std::array<float, 16> &model) {
+  _model = model;
+  mark_dirty();
+}
+
+void StaticBatch::draw() {
+  if (!_mesh)
+    throw std::runtime_error("Static batch is not built");
+  ShaderContextManager context(*_shader);
+  {
+    _shader->set(_model_uniform, _model);
+    _mesh->draw();
+  }
+}
+
+void StaticBatch::submit(RenderQueue &queue, RenderPass pass) {
+  if (!_mesh)
+    throw std::runtime_error("Static batch is not built");
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _mesh->vertex_array(), queue.depth(_model), this);
+}
+
+} // namespace darparu::renderer::entities
@@ -0,0 +1,53 @@
+#pragma once
+#include "darparu/renderer/entities/geometry.h"
+#include "darparu/renderer/renderable.h"
+#include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
+#include <GL/glew.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace darparu::renderer::entities {
+
+// Merges static scenery into one vertex and index buffer at scene build time, so it costs a single draw call and no
+// per object uniforms each frame. Geometry is pre-transformed into the batch's space when added.
+class StaticBatch : public Renderable {
+public:
+  StaticBatch();
+  ~StaticBatch();
+
+  StaticBatch(const StaticBatch &) = delete;
+  StaticBatch &operator=(const StaticBatch &) = delete;
+
+  StaticBatch(StaticBatch &&other) = delete;
+  StaticBatch &operator=(StaticBatch &&other) = delete;
+
+  // Appends geometry placed by model, which is row-major like the entities' models. Emissive geometry is drawn in its
+  // flat colour, unlit, like a Light.
+  void add(const Geometry &geometry, const std::array<float, 16> &model, const std::array<float, 3> &color,
+           bool emissive = false);
+  // Uploads everything added so far, after which nothing more can be added.
+  void build();
+
+  // Applied to the whole batch after each part's own model.
+  void set_model(const std::array<float, 16> &model);
+
+  void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
+
+private:
+  // Position, normal, colour and emissive flag.
+  static constexpr size_t VERTEX_SIZE = 10;
+
+  std::vector<float> _vertices;
+  std::vector<unsigned int> _indices;
+
+  std::array<float, 16> _model{};
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  std::unique_ptr<StaticMesh> _mesh;
+};
+
+} // namespace darparu::renderer::entities
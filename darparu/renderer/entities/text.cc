@@ -0,0 +1,199 @@
+#include "darparu/renderer/entities/text.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include "darparu/renderer/resource_cache.h"
+#include "darparu/renderer/shader_context_manager.h"
+#include <GL/glew.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace darparu::renderer::entities {
+
+static constexpr int ATLAS_WIDTH = 512;
+// Empty texels around each glyph so linear filtering never picks up a neighbour.
+static constexpr int ATLAS_PADDING = 1;
+
+Text::Text(const std::filesystem::path &font_path, unsigned int pixel_height)
+    : _shader(resource_cache().shader("darparu/renderer/shaders/text.vs", "darparu/renderer/shaders/text.fs")),
+      _screen_size_uniform(_shader->uniform<std::array<float, 2>>("screen_size")),
+      _atlas_uniform(_shader->uniform<int>("atlas")), _atlas(0), _instance_vbo(0), _vao(0) {
+  if (pixel_height == 0)
+    throw std::invalid_argument("Invalid text pixel height");
+  rasterise_atlas(font_path, pixel_height);
+
+  glGenBuffers(1, &_instance_vbo);
+  glGenVertexArrays(1, &_vao);
+  gl_state().bind_vertex_array(_vao);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _instance_vbo);
+  // The quad's corners come from gl_VertexID, every attribute is per glyph.
+  GL_CALL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                                reinterpret_cast<void *>(offsetof(GlyphInstance, rect))));
+  GL_CALL(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                                reinterpret_cast<void *>(offsetof(GlyphInstance, uv))));
+  GL_CALL(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance),
+                                reinterpret_cast<void *>(offsetof(GlyphInstance, color))));
+  for (GLuint location = 0; location < 3; ++location) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+  }
+  gl_state().bind_vertex_array(0);
+}
+
+Text::~Text() {
+  if (_atlas != 0)
+    gl_state().delete_texture(_atlas);
+  if (_instance_vbo != 0)
+    gl_state().delete_buffer(_instance_vbo);
+  if (_vao != 0)
+    gl_state().delete_vertex_array(_vao);
+  memory_tracker().release_host(this);
+}
+
+void Text::rasterise_atlas(const std::filesystem::path &font_path, unsigned int pixel_height) {
+  FT_Library library;
+  if (FT_Init_FreeType(&library))
+    throw std::runtime_error("Could not initialize FreeType");
+  FT_Face face;
+  if (FT_New_Face(library, font_path.c_str(), 0, &face)) {
+    FT_Done_FreeType(library);
+    throw std::runtime_error("Could not load font " + font_path.string());
+  }
+  FT_Set_Pixel_Sizes(face, 0, pixel_height);
+  _line_height = static_cast<float>(face->size->metrics.height >> 6);
+  _ascender = static_cast<float>(face->size->metrics.ascender >> 6);
+
+  // Shelf pack the glyphs into rows of the atlas, keeping each bitmap until the atlas' height is known.
+  struct Placed {
+    std::vector<std::uint8_t> bitmap;
+    int x, y, width, height;
+  };
+  std::vector<Placed> placed(_glyphs.size());
+  int x = ATLAS_PADDING, y = ATLAS_PADDING, row_height = 0;
+  for (size_t i = 0; i < _glyphs.size(); ++i) {
+    if (FT_Load_Char(face, FIRST_GLYPH + i, FT_LOAD_RENDER))
+      continue;
+    const FT_GlyphSlot slot = face->glyph;
+    const int width = static_cast<int>(slot->bitmap.width);
+    const int height = static_cast<int>(slot->bitmap.rows);
+    if (x + width + ATLAS_PADDING > ATLAS_WIDTH) {
+      x = ATLAS_PADDING;
+      y += row_height + ATLAS_PADDING;
+      row_height = 0;
+    }
+    auto &glyph = placed[i];
+    glyph = {std::vector<std::uint8_t>(width * height), x, y, width, height};
+    for (int row = 0; row < height; ++row)
+      std::copy_n(slot->bitmap.buffer + row * slot->bitmap.pitch, width, glyph.bitmap.begin() + row * width);
+    _glyphs[i] = {{}, static_cast<float>(width), static_cast<float>(height), static_cast<float>(slot->bitmap_left),
+                  static_cast<float>(slot->bitmap_top), static_cast<float>(slot->advance.x >> 6)};
+    x += width + ATLAS_PADDING;
+    row_height = std::max(row_height, height);
+  }
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+
+  const int atlas_height = y + row_height + ATLAS_PADDING;
+  std::vector<std::uint8_t> atlas(ATLAS_WIDTH * atlas_height, 0);
+  for (size_t i = 0; i < _glyphs.size(); ++i) {
+    const auto &glyph = placed[i];
+    for (int row = 0; row < glyph.height; ++row)
+      std::copy_n(glyph.bitmap.begin() + row * glyph.width, glyph.width,
+                  atlas.begin() + (glyph.y + row) * ATLAS_WIDTH + glyph.x);
+    _glyphs[i].uv = {static_cast<float>(glyph.x) / ATLAS_WIDTH, static_cast<float>(glyph.y) / atlas_height,
+                     static_cast<float>(glyph.x + glyph.width) / ATLAS_WIDTH,
+                     static_cast<float>(glyph.y + glyph.height) / atlas_height};
+  }
+
+  glGenTextures(1, &_atlas);
+  gl_state().bind_texture(0, GL_TEXTURE_2D, _atlas);
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, atlas_height, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data()));
+  GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  memory_tracker().track(MemoryKind::texture, _atlas, atlas.size(), this, "Text");
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Text::set_screen_size(int width, int height) {
+  const std::array<float, 2> size{static_cast<float>(std::max(width, 1)), static_cast<float>(std::max(height, 1))};
+  if (size == _screen_size)
+    return;
+  _screen_size = size;
+  mark_dirty();
+}
+
+void Text::clear() {
+  if (_instances.empty())
+    return;
+  _instances.clear();
+  _dirty = true;
+  mark_dirty();
+}
+
+float Text::add(std::string_view text, float x, float y, const std::array<float, 3> &color) {
+  // Glyphs are snapped to whole pixels so the atlas is sampled texel for texel.
+  x = std::round(x);
+  const float baseline = std::round(y + _ascender);
+  for (char c : text) {
+    if (c < FIRST_GLYPH || c > LAST_GLYPH)
+      continue;
+    const auto &glyph = _glyphs[c - FIRST_GLYPH];
+    if (glyph.width > 0.0f && glyph.height > 0.0f)
+      _instances.push_back(
+          {{x + glyph.bearing_x, baseline - glyph.bearing_y, glyph.width, glyph.height}, glyph.uv, color});
+    x += glyph.advance;
+  }
+  _dirty = true;
+  mark_dirty();
+  return x;
+}
+
+void Text::upload() {
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _instance_vbo);
+  const size_t bytes = _instances.size() * sizeof(GlyphInstance);
+  if (_instances.size() > _instance_capacity) {
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, bytes, _instances.data(), GL_DYNAMIC_DRAW));
+    _instance_capacity = _instances.size();
+    memory_tracker().track(MemoryKind::buffer, _instance_vbo, bytes, this, "Text");
+    memory_tracker().track_host(this, "Text", "instances", _instances);
+  } else {
+    // Orphan the old storage so the update does not wait on draws still reading it.
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, _instance_capacity * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW));
+    GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, _instances.data()));
+  }
+  _dirty = false;
+}
+
+void Text::draw() {
+  if (_instances.empty())
+    return;
+  if (_dirty)
+    upload();
+  ShaderContextManager context(*_shader);
+  _shader->set(_screen_size_uniform, _screen_size);
+  _shader->set(_atlas_uniform, 0);
+  gl_state().bind_texture(0, GL_TEXTURE_2D, _atlas);
+  gl_state().set_enabled(GL_DEPTH_TEST, false);
+  gl_state().depth_mask(false);
+  gl_state().bind_vertex_array(_vao);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, _instances.size());
+  gl_state().count_draw(GL_TRIANGLE_STRIP, 4, _instances.size());
+  gl_state().depth_mask(true);
+  gl_state().set_enabled(GL_DEPTH_TEST, true);
+}
+
+void Text::submit(RenderQueue &queue, RenderPass pass) {
+  // Nearest transparent draws go last, so zero depth puts the text over everything.
+  queue.submit(pass, RenderLayer::transparent, _shader->id(), _vao, 0.0f, this);
+}
+
+} // namespace darparu::renderer::entities
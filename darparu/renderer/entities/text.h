@@ -0,0 +1,78 @@
+#pragma once
+#include "darparu/renderer/renderable.h"
+#include "darparu/renderer/shader.h"
+#include <GL/glew.h>
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace darparu::renderer::entities {
+
+// Screen space text. The printable ASCII glyphs of a font are rasterised once with FreeType into an atlas texture, and
+// all text is drawn with one instanced draw call of a quad per glyph, on top of everything else.
+class Text : public Renderable {
+public:
+  Text(const std::filesystem::path &font_path, unsigned int pixel_height = 16);
+  ~Text();
+
+  Text(const Text &) = delete;
+  Text &operator=(const Text &) = delete;
+
+  Text(Text &&other) = delete;
+  Text &operator=(Text &&other) = delete;
+
+  // Text is laid out in framebuffer pixels, so the model is ignored.
+  void set_model(const std::array<float, 16> &model) {}
+  void set_screen_size(int width, int height);
+
+  void clear();
+  // Lays out a line with its top left corner at x, y pixels from the top left of the screen. Characters without a glyph
+  // are skipped. Returns the x after the line.
+  float add(std::string_view text, float x, float y, const std::array<float, 3> &color);
+  float line_height() const { return _line_height; }
+
+  void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
+
+private:
+  static constexpr char FIRST_GLYPH = ' ';
+  static constexpr char LAST_GLYPH = '~';
+
+  struct Glyph {
+    // u0, v0, u1, v1 in the atlas.
+    std::array<float, 4> uv;
+    float width, height;
+    float bearing_x, bearing_y;
+    float advance;
+  };
+
+  struct GlyphInstance {
+    // x, y, width and height in pixels.
+    std::array<float, 4> rect;
+    std::array<float, 4> uv;
+    std::array<float, 3> color;
+  };
+
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 2>> _screen_size_uniform;
+  Uniform<int> _atlas_uniform;
+  std::array<float, 2> _screen_size{1.0f, 1.0f};
+
+  std::array<Glyph, LAST_GLYPH - FIRST_GLYPH + 1> _glyphs{};
+  float _line_height = 0.0f;
+  float _ascender = 0.0f;
+  GLuint _atlas;
+
+  std::vector<GlyphInstance> _instances;
+  GLuint _instance_vbo;
+  GLuint _vao;
+  size_t _instance_capacity = 0;
+  bool _dirty = false;
+
+  void rasterise_atlas(const std::filesystem::path &font_path, unsigned int pixel_height);
+  void upload();
+};
+
+} // namespace darparu::renderer::entities
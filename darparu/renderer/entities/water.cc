@@ -1,20 +1,20 @@
 #include "darparu/renderer/entities/water.h"
+#include "darparu/profile.h"
 #include "darparu/renderer/entities/water_normals.h"
+#include "darparu/renderer/entities/water_packing.h"
 #include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include "darparu/renderer/resource_cache.h"
 #include "darparu/renderer/shader.h"
 #include "darparu/renderer/shader_context_manager.h"
 #include <GL/glew.h>
+#include <algorithm>
 #include <array>
 #include <string>
 #include <vector>
 namespace darparu::renderer::entities {
 
-struct WaterData {
-  std::vector<float> vertices;
-  std::vector<float> normals;
-  std::vector<unsigned int> indices;
-};
-
 WaterData grid_vertices_normals_and_indices(int n_cells_x, int n_cells_z, double cell_size) {
   std::vector<float> vertices;
   std::vector<float> normals;
@@ -55,22 +55,39 @@ WaterData grid_vertices_normals_and_indices(int n_cells_x, int n_cells_z, double
   return {vertices, normals, indices};
 }
 
-Water::Water(size_t resolution, float xz_offset)
-    : _resolution(resolution), _shader(read_file("darparu/renderer/shaders/basic_lighting.vs"),
-                                       read_file("darparu/renderer/shaders/basic_lighting.fs")),
-      _xz_vbo(0), _y_vbo(0), _normal_vbo(0), _vao(0), _ebo(0), _vertex_normals(3 * _resolution * _resolution),
-      _face_normals((_resolution - 1) * (_resolution - 1) * 2 * 3), _count(_resolution * _resolution, 0) {
+Water::Water(size_t resolution, float xz_offset, WaterVertexFormat format)
+    : _resolution(resolution), _format(format),
+      _shader(resource_cache().shader(format == WaterVertexFormat::compact
+                                          ? "darparu/renderer/shaders/basic_lighting_compact.vs"
+                                          : "darparu/renderer/shaders/basic_lighting.vs",
+                                      "darparu/renderer/shaders/basic_lighting.fs")),
+      _model_uniform(_shader->uniform<std::array<float, 16>>("model")),
+      _color_uniform(_shader->uniform<std::array<float, 3>>("objectColor")),
+      _background_uniform(_shader->uniform<int>("background")), _xz_vbo(0), _y_vbo(0), _normal_vbo(0), _vao(0), _ebo(0),
+      _vertex_normals(3 * _resolution * _resolution), _face_normals((_resolution - 1) * (_resolution - 1) * 2 * 3),
+      _count(_resolution * _resolution, 0) {
+  if (_format == WaterVertexFormat::compact) {
+    _packed_heights.resize(_resolution * _resolution);
+    _packed_normals.resize(2 * _resolution * _resolution);
+  }
   WaterData mesh_data = grid_vertices_normals_and_indices(_resolution, _resolution, 1.0f / (_resolution - 1));
   std::transform(mesh_data.vertices.begin(), mesh_data.vertices.end(), mesh_data.vertices.begin(),
                  [&](auto &value) { return value + xz_offset; });
   _xz = mesh_data.vertices;
+  const auto [xz_min, xz_max] = std::minmax_element(_xz.begin(), _xz.end());
+  _bounds = {{*xz_min, 0.0f, *xz_min}, {*xz_max, 0.0f, *xz_max}};
   _xz_vbo = init_vbo(mesh_data.vertices);
-  _y_vbo = init_vbo(_resolution * _resolution * sizeof(float), true);
-  _normal_vbo = init_vbo(3 * _resolution * _resolution * sizeof(float), true);
+  if (_format == WaterVertexFormat::compact) {
+    _y_vbo = init_vbo(_packed_heights.size() * sizeof(std::uint16_t), true);
+    _normal_vbo = init_vbo(_packed_normals.size() * sizeof(std::int16_t), true);
+  } else {
+    _y_vbo = init_vbo(_resolution * _resolution * sizeof(float), true);
+    _normal_vbo = init_vbo(3 * _resolution * _resolution * sizeof(float), true);
+  }
   _ebo = init_ebo(mesh_data.indices);
   _vao = init_vao(_xz_vbo, _y_vbo, _normal_vbo, _ebo, mesh_data.vertices);
   _indices = mesh_data.indices;
-  glBindVertexArray(0);
+  gl_state().bind_vertex_array(0);
 
   size_t max_face_index = (_resolution - 1) * (_resolution - 1) * 2;
   for (size_t face_index = 0; face_index < max_face_index; ++face_index) {
@@ -79,111 +96,112 @@ Water::Water(size_t resolution, float xz_offset)
       ++_count[vertex_index];
     }
   }
+
+  // The CPU side copies are sized once, set_heights only rewrites them.
+  memory_tracker().track_host(this, "Water", "indices", _indices);
+  memory_tracker().track_host(this, "Water", "xz", _xz);
+  memory_tracker().track_host(this, "Water", "vertex normals", _vertex_normals);
+  memory_tracker().track_host(this, "Water", "face normals", _face_normals);
+  memory_tracker().track_host(this, "Water", "normal counts", _count);
+  memory_tracker().track_host(this, "Water", "packed heights", _packed_heights);
+  memory_tracker().track_host(this, "Water", "packed normals", _packed_normals);
 }
 
 Water::~Water() {
   if (_xz_vbo != 0)
-    glDeleteBuffers(1, &_xz_vbo);
+    gl_state().delete_buffer(_xz_vbo);
   if (_y_vbo != 0)
-    glDeleteBuffers(1, &_y_vbo);
+    gl_state().delete_buffer(_y_vbo);
   if (_normal_vbo != 0)
-    glDeleteBuffers(1, &_normal_vbo);
+    gl_state().delete_buffer(_normal_vbo);
   if (_ebo != 0)
-    glDeleteBuffers(1, &_ebo);
+    gl_state().delete_buffer(_ebo);
   if (_vao != 0)
-    glDeleteVertexArrays(1, &_vao);
+    gl_state().delete_vertex_array(_vao);
+  memory_tracker().release_host(this);
 }
 
 GLuint Water::init_vbo(const std::vector<float> &vertices) {
   GLuint vbo;
   glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo);
   glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+  memory_tracker().track(MemoryKind::buffer, vbo, vertices.size() * sizeof(float), this, "Water");
   return vbo;
 }
 
 GLuint Water::init_vbo(size_t bytes, bool dynamic) {
   GLuint vbo;
   glGenBuffers(1, &vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo);
   glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+  memory_tracker().track(MemoryKind::buffer, vbo, bytes, this, "Water");
   return vbo;
 }
 
 GLuint Water::init_ebo(const std::vector<unsigned int> &indices) {
   GLuint ebo;
   glGenBuffers(1, &ebo);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+  gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+  memory_tracker().track(MemoryKind::buffer, ebo, indices.size() * sizeof(unsigned int), this, "Water");
   return ebo;
 }
 
 GLuint Water::init_vao(GLuint xz_vbo, GLuint y_vbo, GLuint normal_vbo, GLuint ebo, const std::vector<float> &vertices) {
   GLuint vao;
   glGenVertexArrays(1, &vao);
-  glBindVertexArray(vao);
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-  glBindBuffer(GL_ARRAY_BUFFER, xz_vbo);
+  gl_state().bind_vertex_array(vao);
+  gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, xz_vbo);
   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), reinterpret_cast<void *>(0));
   glEnableVertexAttribArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, normal_vbo);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void *>(0));
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, normal_vbo);
+  if (_format == WaterVertexFormat::compact)
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, 2 * sizeof(std::int16_t), reinterpret_cast<void *>(0));
+  else
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void *>(0));
   glEnableVertexAttribArray(1);
-  glBindBuffer(GL_ARRAY_BUFFER, y_vbo);
-  glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), reinterpret_cast<void *>(0));
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, y_vbo);
+  if (_format == WaterVertexFormat::compact)
+    glVertexAttribPointer(2, 1, GL_HALF_FLOAT, GL_FALSE, sizeof(std::uint16_t), reinterpret_cast<void *>(0));
+  else
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float), reinterpret_cast<void *>(0));
   glEnableVertexAttribArray(2);
-  glBindVertexArray(0);
+  gl_state().bind_vertex_array(0);
   return vao;
 }
 
-void Water::set_view(const std::array<float, 16> &view) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_matrix("view", view);
-}
-
-void Water::set_view_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_vector("viewPos", position);
-}
-
-void Water::set_projection(const std::array<float, 16> &projection) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_matrix("projection", projection);
-}
-
 void Water::set_model(const std::array<float, 16> &model) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_matrix("model", model);
+  _model = model;
+  mark_dirty();
 }
 
 void Water::set_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_vector("objectColor", color);
-}
-
-void Water::set_light_position(const std::array<float, 3> &position) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_vector("lightPos", position);
-}
-
-void Water::set_light_color(const std::array<float, 3> &color) {
-  ShaderContextManager context(_shader);
-  _shader.set_uniform_vector("lightColor", color);
+  _color = color;
+  mark_dirty();
 }
 
 void Water::set_texture(Texture &texture) {
-  texture.use();
-  {
-    ShaderContextManager context(_shader);
-    _shader.set_uniform("background", 0);
-  }
+  _texture = texture;
+  mark_dirty();
 }
 
 void Water::set_heights(const std::vector<float> &heights) {
+  DARPARU_PROFILE_ZONE("Water::set_heights");
   if (heights.size() != (_resolution * _resolution))
     throw std::invalid_argument("Invalid heights size");
-  glBindBuffer(GL_ARRAY_BUFFER, _y_vbo);
-  GL_CALL(glBufferData(GL_ARRAY_BUFFER, heights.size() * sizeof(float), heights.data(), GL_DYNAMIC_DRAW));
+  const auto [height_min, height_max] = std::minmax_element(heights.begin(), heights.end());
+  _bounds.min[1] = *height_min;
+  _bounds.max[1] = *height_max;
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _y_vbo);
+  if (_format == WaterVertexFormat::compact) {
+    pack_heights(heights, _packed_heights);
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, _packed_heights.size() * sizeof(std::uint16_t), _packed_heights.data(),
+                         GL_DYNAMIC_DRAW));
+  } else {
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, heights.size() * sizeof(float), heights.data(), GL_DYNAMIC_DRAW));
+  }
   update_normals(heights);
   set_normals(_vertex_normals);
 }
@@ -191,14 +209,47 @@ void Water::set_heights(const std::vector<float> &heights) {
 void Water::set_normals(const std::vector<float> &normals) {
   if (normals.size() != (3 * _resolution * _resolution))
     throw std::invalid_argument("Invalid normals size");
-  glBindBuffer(GL_ARRAY_BUFFER, _normal_vbo);
-  GL_CALL(glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(float), normals.data(), GL_DYNAMIC_DRAW));
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _normal_vbo);
+  if (_format == WaterVertexFormat::compact) {
+    pack_normals(normals, _packed_normals);
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, _packed_normals.size() * sizeof(std::int16_t), _packed_normals.data(),
+                         GL_DYNAMIC_DRAW));
+  } else {
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(float), normals.data(), GL_DYNAMIC_DRAW));
+  }
+  mark_dirty();
 }
 
 void Water::draw() {
-  ShaderContextManager context(_shader);
-  glBindVertexArray(_vao);
+  ShaderContextManager context(*_shader);
+  _shader->set(_model_uniform, _model);
+  _shader->set(_color_uniform, _color);
+  if (_texture) {
+    _shader->set(_background_uniform, 0);
+    _texture->use();
+  }
+  gl_state().bind_vertex_array(_vao);
   glDrawElements(GL_TRIANGLES, _indices.size(), GL_UNSIGNED_INT, nullptr);
+  gl_state().count_draw(GL_TRIANGLES, _indices.size());
+}
+
+void Water::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, _shader->id(), _vao, queue.depth(_model), this);
+}
+
+std::optional<BoundingBox> Water::refraction_bounds() const {
+  if (!_texture)
+    return std::nullopt;
+  BoundingBox bounds{{_model[3], _model[7], _model[11]}, {_model[3], _model[7], _model[11]}};
+  for (size_t row = 0; row < 3; ++row) {
+    for (size_t column = 0; column < 3; ++column) {
+      const float a = _model[row * 4 + column] * _bounds.min[column];
+      const float b = _model[row * 4 + column] * _bounds.max[column];
+      bounds.min[row] += std::min(a, b);
+      bounds.max[row] += std::max(a, b);
+    }
+  }
+  return bounds;
 }
 
 void Water::update_normals(const std::vector<float> &heights) {
@@ -4,33 +4,54 @@
 #include "darparu/renderer/texture.h"
 #include <GL/glew.h>
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace darparu::renderer::entities {
 
+// full: float heights and xyz float normals (16 bytes per vertex per update).
+// compact: half float heights and octahedral 2x16 bit normals (6 bytes per vertex per update).
+enum class WaterVertexFormat { full, compact };
+
+struct WaterData {
+  // x, z pairs.
+  std::vector<float> vertices;
+  std::vector<float> normals;
+  std::vector<unsigned int> indices;
+};
+
+// A grid of n_cells_x by n_cells_z vertices centred on the origin, with upward normals and two triangles per cell.
+WaterData grid_vertices_normals_and_indices(int n_cells_x, int n_cells_z, double cell_size);
+
 class Water : public Renderable {
 public:
-  Water(size_t resolution, float xz_offset);
+  Water(size_t resolution, float xz_offset, WaterVertexFormat format = WaterVertexFormat::compact);
   ~Water();
 
-  void set_view(const std::array<float, 16> &view);
-  void set_view_position(const std::array<float, 3> &position);
-  void set_projection(const std::array<float, 16> &projection);
   void set_model(const std::array<float, 16> &model);
   void set_color(const std::array<float, 3> &color);
-  void set_light_position(const std::array<float, 3> &position);
-  void set_light_color(const std::array<float, 3> &color);
   void set_texture(Texture &texture);
 
   void set_heights(const std::vector<float> &heights);
   void set_normals(const std::vector<float> &normals);
 
   void draw();
+  void submit(RenderQueue &queue, RenderPass pass);
+  std::optional<BoundingBox> refraction_bounds() const;
 
 private:
   size_t _resolution;
+  WaterVertexFormat _format;
+
+  std::array<float, 16> _model{};
+  std::array<float, 3> _color{};
 
-  Shader _shader;
+  std::shared_ptr<Shader> _shader;
+  Uniform<std::array<float, 16>> _model_uniform;
+  Uniform<std::array<float, 3>> _color_uniform;
+  Uniform<int> _background_uniform;
   GLuint _xz_vbo;
   GLuint _y_vbo;
   GLuint _normal_vbo;
@@ -42,6 +63,11 @@ private:
   std::vector<float> _vertex_normals;
   std::vector<float> _face_normals;
   std::vector<size_t> _count;
+  std::vector<std::uint16_t> _packed_heights;
+  std::vector<std::int16_t> _packed_normals;
+  std::optional<Texture> _texture;
+  // Model space box around the grid and its current heights.
+  BoundingBox _bounds{};
 
   GLuint init_vbo(const std::vector<float> &vertices);
   GLuint init_vbo(size_t bytes, bool dynamic);
@@ -1,10 +1,12 @@
 #include "darparu/renderer/entities/water_normals.h"
+#include "darparu/profile.h"
 #include "darparu/renderer/algebra.h"
 namespace darparu::renderer::entities {
 
 void update_water_normals(std::vector<float> &vertex_normals, std::vector<float> &face_normals,
                           const std::vector<float> &heights, size_t resolution, const std::vector<float> &xz,
                           const std::vector<unsigned int> &indices, const std::vector<size_t> &count) {
+  DARPARU_PROFILE_ZONE("update_water_normals");
   if (heights.size() != (resolution * resolution))
     throw std::invalid_argument("Invalid heights size");
 
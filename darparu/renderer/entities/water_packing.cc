@@ -0,0 +1,136 @@
+#include "darparu/renderer/entities/water_packing.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace darparu::renderer::entities {
+
+// Round to nearest even, saturating to infinity, with subnormal support.
+static std::uint16_t float_to_half(float value) {
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  const std::uint32_t sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7fffffffu;
+  if (bits >= 0x7f800000u) // Infinity or NaN.
+    return sign | 0x7c00u | (bits > 0x7f800000u ? 0x200u : 0u);
+  if (bits >= 0x477ff000u) // Too large, rounds to infinity.
+    return sign | 0x7c00u;
+  if (bits < 0x38800000u) { // Subnormal half.
+    if (bits < 0x33000000u)
+      return sign;
+    const std::uint32_t exponent = bits >> 23;
+    const std::uint32_t mantissa = (bits & 0x7fffffu) | 0x800000u;
+    const std::uint32_t shift = 126 - exponent;
+    std::uint32_t half_mantissa = mantissa >> shift;
+    const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const std::uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u)))
+      ++half_mantissa;
+    return sign | half_mantissa;
+  }
+  // Rebias the exponent from 127 to 15 and round the mantissa to nearest even.
+  bits += 0xc8000fffu + ((bits >> 13) & 1u);
+  return sign | (bits >> 13);
+}
+
+static std::int16_t to_snorm16(float value) {
+  return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static void pack_normal(float x, float y, float z, std::int16_t *packed) {
+  const float inverse_l1 = 1.0f / std::max(std::abs(x) + std::abs(y) + std::abs(z), 1e-20f);
+  float u = x * inverse_l1;
+  float v = z * inverse_l1;
+  if (y < 0.0f) {
+    const float folded_u = std::copysign(1.0f - std::abs(v), u);
+    const float folded_v = std::copysign(1.0f - std::abs(u), v);
+    u = folded_u;
+    v = folded_v;
+  }
+  packed[0] = to_snorm16(u);
+  packed[1] = to_snorm16(v);
+}
+
+void pack_heights(std::span<const float> heights, std::span<std::uint16_t> packed) {
+  if (heights.size() != packed.size())
+    throw std::invalid_argument("Invalid packed heights size");
+  size_t i = 0;
+#if defined(__F16C__) && defined(__AVX__)
+  for (; i + 8 <= heights.size(); i += 8) {
+    const __m256 values = _mm256_loadu_ps(heights.data() + i);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(packed.data() + i),
+                     _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  for (; i + 4 <= heights.size(); i += 4) {
+    const float16x4_t values = vcvt_f16_f32(vld1q_f32(heights.data() + i));
+    vst1_u16(packed.data() + i, vreinterpret_u16_f16(values));
+  }
+#endif
+  for (; i < heights.size(); ++i)
+    packed[i] = float_to_half(heights[i]);
+}
+
+void pack_normals(std::span<const float> normals, std::span<std::int16_t> packed) {
+  if (normals.size() % 3 != 0 || normals.size() / 3 * 2 != packed.size())
+    throw std::invalid_argument("Invalid packed normals size");
+  const size_t count = normals.size() / 3;
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 epsilon = _mm_set1_ps(1e-20f);
+  const __m128 snorm_scale = _mm_set1_ps(32767.0f);
+  for (; i + 4 <= count; i += 4) {
+    const float *n = normals.data() + 3 * i;
+    const __m128 x = _mm_setr_ps(n[0], n[3], n[6], n[9]);
+    const __m128 y = _mm_setr_ps(n[1], n[4], n[7], n[10]);
+    const __m128 z = _mm_setr_ps(n[2], n[5], n[8], n[11]);
+    const __m128 l1 = _mm_max_ps(
+        _mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign_mask, x), _mm_andnot_ps(sign_mask, y)), _mm_andnot_ps(sign_mask, z)),
+        epsilon);
+    __m128 u = _mm_div_ps(x, l1);
+    __m128 v = _mm_div_ps(z, l1);
+    // Fold the lower hemisphere over the diagonals, 1 - |v| is never negative so or-ing in the sign is a copysign.
+    const __m128 folded_u = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, v)), _mm_and_ps(u, sign_mask));
+    const __m128 folded_v = _mm_or_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, u)), _mm_and_ps(v, sign_mask));
+    const __m128 lower = _mm_cmplt_ps(y, _mm_setzero_ps());
+    u = _mm_or_ps(_mm_and_ps(lower, folded_u), _mm_andnot_ps(lower, u));
+    v = _mm_or_ps(_mm_and_ps(lower, folded_v), _mm_andnot_ps(lower, v));
+    const __m128i packed_u = _mm_cvtps_epi32(_mm_mul_ps(u, snorm_scale));
+    const __m128i packed_v = _mm_cvtps_epi32(_mm_mul_ps(v, snorm_scale));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(packed.data() + 2 * i),
+                     _mm_unpacklo_epi16(_mm_packs_epi32(packed_u, packed_u), _mm_packs_epi32(packed_v, packed_v)));
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const uint32x4_t sign_mask = vdupq_n_u32(0x80000000u);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t epsilon = vdupq_n_f32(1e-20f);
+  const float32x4_t snorm_scale = vdupq_n_f32(32767.0f);
+  for (; i + 4 <= count; i += 4) {
+    const float32x4x3_t n = vld3q_f32(normals.data() + 3 * i);
+    const float32x4_t l1 =
+        vmaxq_f32(vaddq_f32(vaddq_f32(vabsq_f32(n.val[0]), vabsq_f32(n.val[1])), vabsq_f32(n.val[2])), epsilon);
+    float32x4_t u = vdivq_f32(n.val[0], l1);
+    float32x4_t v = vdivq_f32(n.val[2], l1);
+    const float32x4_t folded_u = vbslq_f32(sign_mask, u, vsubq_f32(one, vabsq_f32(v)));
+    const float32x4_t folded_v = vbslq_f32(sign_mask, v, vsubq_f32(one, vabsq_f32(u)));
+    const uint32x4_t lower = vcltq_f32(n.val[1], vdupq_n_f32(0.0f));
+    u = vbslq_f32(lower, folded_u, u);
+    v = vbslq_f32(lower, folded_v, v);
+    const int16x4x2_t uv = {vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(u, snorm_scale))),
+                            vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(v, snorm_scale)))};
+    vst2_s16(packed.data() + 2 * i, uv);
+  }
+#endif
+  for (; i < count; ++i)
+    pack_normal(normals[3 * i], normals[3 * i + 1], normals[3 * i + 2], packed.data() + 2 * i);
+}
+
+} // namespace darparu::renderer::entities
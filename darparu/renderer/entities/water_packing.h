@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+namespace darparu::renderer::entities {
+
+// Converts heights to IEEE 754 half floats, suitable for a GL_HALF_FLOAT vertex attribute.
+void pack_heights(std::span<const float> heights, std::span<std::uint16_t> packed);
+
+// Octahedral encodes unit normals (x, y, z triplets) into (u, v) pairs of 16 bit signed normalized integers. The y axis
+// is used as the octahedron's pole, so upward facing normals keep the most precision.
+void pack_normals(std::span<const float> normals, std::span<std::int16_t> packed);
+
+} // namespace darparu::renderer::entities
@@ -0,0 +1,132 @@
+#include "darparu/renderer/frame_capture.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace darparu::renderer {
+
+FrameCapture::FrameCapture(std::filesystem::path directory, size_t ring_size, size_t workers)
+    : _directory(std::move(directory)), _slots(ring_size) {
+  if (ring_size == 0 || workers == 0)
+    throw std::invalid_argument("Frame capture needs at least one buffer and one worker");
+  std::filesystem::create_directories(_directory);
+  for (auto &slot : _slots)
+    glGenBuffers(1, &slot.buffer);
+  for (size_t i = 0; i < workers; ++i)
+    _workers.emplace_back(&FrameCapture::work, this);
+}
+
+FrameCapture::~FrameCapture() {
+  try {
+    flush();
+  } catch (const std::exception &error) {
+    std::cerr << "Frame capture: " << error.what() << std::endl;
+  }
+  {
+    std::lock_guard lock(_mutex);
+    _stopping = true;
+  }
+  _queue_changed.notify_all();
+  for (auto &worker : _workers)
+    worker.join();
+  for (auto &slot : _slots)
+    gl_state().delete_buffer(slot.buffer);
+}
+
+void FrameCapture::capture(GLuint framebuffer, int width, int height) {
+  Slot &slot = _slots[_next_slot];
+  _next_slot = (_next_slot + 1) % _slots.size();
+  retire(slot);
+
+  const size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 3;
+  gl_state().bind_buffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  if (slot.bytes != bytes) {
+    GL_CALL(glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ));
+    memory_tracker().track(MemoryKind::buffer, slot.buffer, bytes, this, "FrameCapture");
+    slot.bytes = bytes;
+  }
+  gl_state().bind_framebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+  GL_CALL(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  GL_CALL(glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr));
+  gl_state().bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  slot.width = width;
+  slot.height = height;
+  slot.frame = _frames_captured++;
+}
+
+void FrameCapture::flush() {
+  // Oldest first, so the images reach the workers in order.
+  for (size_t i = 0; i < _slots.size(); ++i)
+    retire(_slots[(_next_slot + i) % _slots.size()]);
+}
+
+void FrameCapture::retire(Slot &slot) {
+  if (!slot.fence)
+    return;
+  GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    ++_stalls;
+    status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+  }
+  glDeleteSync(slot.fence);
+  slot.fence = nullptr;
+  if (status == GL_WAIT_FAILED)
+    throw std::runtime_error("Failed waiting for a frame capture");
+
+  Image image{std::vector<std::uint8_t>(slot.bytes), slot.width, slot.height, slot.frame};
+  gl_state().bind_buffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  const void *mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.bytes, GL_MAP_READ_BIT);
+  if (!mapped)
+    throw std::runtime_error("Failed mapping a frame capture");
+  std::memcpy(image.pixels.data(), mapped, slot.bytes);
+  GL_CALL(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+  gl_state().bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  std::unique_lock lock(_mutex);
+  _queue_changed.wait(lock, [this] { return _queue.size() < MAX_QUEUED_IMAGES; });
+  _queue.push_back(std::move(image));
+  lock.unlock();
+  _queue_changed.notify_all();
+}
+
+void FrameCapture::work() {
+  while (true) {
+    std::unique_lock lock(_mutex);
+    _queue_changed.wait(lock, [this] { return _stopping || !_queue.empty(); });
+    if (_queue.empty())
+      return;
+    Image image = std::move(_queue.front());
+    _queue.pop_front();
+    lock.unlock();
+    _queue_changed.notify_all();
+    try {
+      write(image);
+    } catch (const std::exception &error) {
+      std::cerr << "Frame capture: " << error.what() << std::endl;
+    }
+  }
+}
+
+void FrameCapture::write(const Image &image) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "frame_%06zu.ppm", image.frame);
+  const auto path = _directory / name;
+  std::ofstream file(path, std::ios::binary);
+  if (!file)
+    throw std::runtime_error("Could not open " + path.string());
+  file << "P6\n" << image.width << " " << image.height << "\n255\n";
+  // GL rows start at the bottom, PPM rows at the top.
+  const size_t row_bytes = static_cast<size_t>(image.width) * 3;
+  for (int row = image.height - 1; row >= 0; --row)
+    file.write(reinterpret_cast<const char *>(image.pixels.data() + row * row_bytes), row_bytes);
+  if (!file)
+    throw std::runtime_error("Could not write " + path.string());
+}
+
+} // namespace darparu::renderer
@@ -0,0 +1,74 @@
+#pragma once
+#include <GL/glew.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace darparu::renderer {
+
+// Reads frames back without stalling the GPU and writes them as binary PPM images. Each frame is read into one of a
+// ring of pixel pack buffers, which is only mapped when the ring comes back around to it, a ring size of frames later,
+// by when its fence has normally signalled. Images are flipped and written to disk on worker threads.
+// Needs the GL context it captures from to be current for its whole lifetime.
+class FrameCapture {
+public:
+  FrameCapture(std::filesystem::path directory, size_t ring_size = 3, size_t workers = 2);
+  ~FrameCapture();
+
+  FrameCapture(const FrameCapture &) = delete;
+  FrameCapture &operator=(const FrameCapture &) = delete;
+
+  FrameCapture(FrameCapture &&other) = delete;
+  FrameCapture &operator=(FrameCapture &&other) = delete;
+
+  // Queues a read of the framebuffer's colour, which for the default framebuffer has to happen before swapping.
+  void capture(GLuint framebuffer, int width, int height);
+  // Waits for all queued reads and hands them to the workers, e.g. before the context goes away.
+  void flush();
+
+  size_t frames_captured() const { return _frames_captured; }
+  // Times the oldest read was not finished when its buffer was needed again, so capturing waited on the GPU.
+  size_t stalls() const { return _stalls; }
+
+private:
+  struct Slot {
+    GLuint buffer = 0;
+    GLsync fence = nullptr;
+    size_t bytes = 0;
+    int width = 0;
+    int height = 0;
+    size_t frame = 0;
+  };
+
+  struct Image {
+    std::vector<std::uint8_t> pixels;
+    int width;
+    int height;
+    size_t frame;
+  };
+
+  // Bounds the images waiting for a worker, so a slow disk throttles capturing rather than filling memory.
+  static constexpr size_t MAX_QUEUED_IMAGES = 8;
+
+  std::filesystem::path _directory;
+  std::vector<Slot> _slots;
+  size_t _next_slot = 0;
+  size_t _frames_captured = 0;
+  size_t _stalls = 0;
+
+  std::mutex _mutex;
+  std::condition_variable _queue_changed;
+  std::deque<Image> _queue;
+  bool _stopping = false;
+  std::vector<std::thread> _workers;
+
+  void retire(Slot &slot);
+  void work();
+  void write(const Image &image) const;
+};
+
+} // namespace darparu::renderer
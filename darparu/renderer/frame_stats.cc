@@ -0,0 +1,86 @@
+#include "darparu/renderer/frame_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace darparu::renderer {
+
+std::ostream &operator<<(std::ostream &stream, const FrameStatsSummary &summary) {
+  return stream << "Frames: " << summary.frames << ", min: " << summary.min_ms << "ms, mean: " << summary.mean_ms
+                << "ms, p50: " << summary.p50_ms << "ms, p95: " << summary.p95_ms << "ms, p99: " << summary.p99_ms
+                << "ms, max: " << summary.max_ms << "ms, over budget: " << summary.over_budget;
+}
+
+FrameStats::FrameStats(double budget_ms, size_t window) : _budget_ms(budget_ms) { set_window(window); }
+
+FrameStats::~FrameStats() {
+  if (_report && _count > 0)
+    *_report << summary() << std::endl;
+}
+
+void FrameStats::add(double milliseconds) {
+  _window[_total_frames % _window.size()] = milliseconds;
+  _count = std::min(_count + 1, _window.size());
+  ++_total_frames;
+
+  if (_csv.is_open())
+    _csv << _total_frames << "," << milliseconds << "\n";
+
+  if (_report) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - _last_report >= _report_interval) {
+      *_report << summary() << std::endl;
+      _last_report = now;
+    }
+  }
+}
+
+FrameStatsSummary FrameStats::summary() const {
+  FrameStatsSummary summary;
+  summary.frames = _count;
+  if (_count == 0)
+    return summary;
+  std::vector<double> sorted(_window.begin(), _window.begin() + _count);
+  std::sort(sorted.begin(), sorted.end());
+  // Nearest rank percentiles.
+  auto percentile = [&](double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  };
+  summary.min_ms = sorted.front();
+  summary.max_ms = sorted.back();
+  summary.mean_ms = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+  summary.p50_ms = percentile(0.50);
+  summary.p95_ms = percentile(0.95);
+  summary.p99_ms = percentile(0.99);
+  summary.over_budget = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), _budget_ms);
+  return summary;
+}
+
+void FrameStats::set_window(size_t window) {
+  if (window == 0)
+    throw std::invalid_argument("Frame stats window must not be empty");
+  _window.assign(window, 0.0);
+  _count = 0;
+  _total_frames = 0;
+}
+
+void FrameStats::set_report(std::ostream *stream, double interval_seconds) {
+  _report = stream;
+  _report_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(interval_seconds));
+  _last_report = std::chrono::steady_clock::now();
+}
+
+void FrameStats::set_csv(const std::filesystem::path &path) {
+  _csv.close();
+  if (path.empty())
+    return;
+  _csv.open(path);
+  if (!_csv)
+    throw std::runtime_error("Could not open " + path.string());
+  _csv << "frame,milliseconds\n";
+}
+
+} // namespace darparu::renderer
@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <vector>
+
+namespace darparu::renderer {
+
+struct FrameStatsSummary {
+  size_t frames = 0;
+  double min_ms = 0.0;
+  double mean_ms = 0.0;
+  double p50_ms = 0.0;
+  double p95_ms = 0.0;
+  double p99_ms = 0.0;
+  double max_ms = 0.0;
+  // Frames that took longer than the budget.
+  size_t over_budget = 0;
+};
+
+std::ostream &operator<<(std::ostream &stream, const FrameStatsSummary &summary);
+
+// Keeps the most recent frame times in a rolling window and summarises them, instead of printing every frame.
+// Optionally reports the summary periodically and on destruction, and appends every frame time to a CSV file.
+class FrameStats {
+public:
+  explicit FrameStats(double budget_ms = 1000.0 / 60.0, size_t window = 1024);
+  ~FrameStats();
+
+  FrameStats(const FrameStats &) = delete;
+  FrameStats &operator=(const FrameStats &) = delete;
+
+  void add(double milliseconds);
+
+  FrameStatsSummary summary() const;
+
+  void set_budget(double budget_ms) { _budget_ms = budget_ms; }
+  double budget() const { return _budget_ms; }
+  // Clears the window and resizes it.
+  void set_window(size_t window);
+  // Writes a summary to the stream every interval, and a final one on destruction. Null to stop reporting.
+  void set_report(std::ostream *stream, double interval_seconds = 5.0);
+  // Appends "frame,milliseconds" rows, empty to stop.
+  void set_csv(const std::filesystem::path &path);
+
+private:
+  double _budget_ms;
+  std::vector<double> _window;
+  size_t _count = 0;
+  size_t _total_frames = 0;
+
+  std::ostream *_report = nullptr;
+  std::chrono::steady_clock::duration _report_interval{};
+  std::chrono::steady_clock::time_point _last_report;
+
+  std::ofstream _csv;
+};
+
+} // namespace darparu::renderer
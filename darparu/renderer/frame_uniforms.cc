@@ -0,0 +1,56 @@
+#include "darparu/renderer/frame_uniforms.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+
+namespace darparu::renderer {
+
+static_assert(sizeof(FrameUniformsData) == 176, "FrameUniformsData must match the std140 layout of Frame");
+
+FrameUniforms::FrameUniforms() : _ubo(0), _data(), _dirty(true) {
+  glGenBuffers(1, &_ubo);
+  gl_state().bind_buffer(GL_UNIFORM_BUFFER, _ubo);
+  GL_CALL(glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformsData), nullptr, GL_DYNAMIC_DRAW));
+  memory_tracker().track(MemoryKind::buffer, _ubo, sizeof(FrameUniformsData), this, "FrameUniforms");
+  GL_CALL(glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, _ubo));
+}
+
+FrameUniforms::~FrameUniforms() {
+  if (_ubo != 0)
+    gl_state().delete_buffer(_ubo);
+}
+
+void FrameUniforms::set_projection(const std::array<float, 16> &projection) {
+  _data.projection = projection;
+  _dirty = true;
+}
+
+void FrameUniforms::set_view(const std::array<float, 16> &view) {
+  _data.view = view;
+  _dirty = true;
+}
+
+void FrameUniforms::set_view_position(const std::array<float, 3> &position) {
+  _data.view_position = {position[0], position[1], position[2], 1.0f};
+  _dirty = true;
+}
+
+void FrameUniforms::set_light_position(const std::array<float, 3> &position) {
+  _data.light_position = {position[0], position[1], position[2], 1.0f};
+  _dirty = true;
+}
+
+void FrameUniforms::set_light_color(const std::array<float, 3> &color) {
+  _data.light_color = {color[0], color[1], color[2], 1.0f};
+  _dirty = true;
+}
+
+void FrameUniforms::upload() {
+  if (!_dirty)
+    return;
+  gl_state().bind_buffer(GL_UNIFORM_BUFFER, _ubo);
+  GL_CALL(glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformsData), &_data));
+  _dirty = false;
+}
+
+} // namespace darparu::renderer
@@ -0,0 +1,45 @@
+#pragma once
+#include <GL/glew.h>
+#include <array>
+
+namespace darparu::renderer {
+
+constexpr GLuint FRAME_UNIFORMS_BINDING = 0;
+constexpr const char *FRAME_UNIFORMS_BLOCK_NAME = "Frame";
+
+// Mirrors the std140 "Frame" uniform block declared by the shaders, vec3 members are padded to 16 bytes.
+struct FrameUniformsData {
+  std::array<float, 16> projection;
+  std::array<float, 16> view;
+  std::array<float, 4> view_position;
+  std::array<float, 4> light_position;
+  std::array<float, 4> light_color;
+};
+
+class FrameUniforms {
+public:
+  FrameUniforms();
+  ~FrameUniforms();
+
+  FrameUniforms(const FrameUniforms &) = delete;
+  FrameUniforms &operator=(const FrameUniforms &) = delete;
+
+  FrameUniforms(FrameUniforms &&other) noexcept = delete;
+  FrameUniforms &operator=(FrameUniforms &&other) noexcept = delete;
+
+  void set_projection(const std::array<float, 16> &projection);
+  void set_view(const std::array<float, 16> &view);
+  void set_view_position(const std::array<float, 3> &position);
+  void set_light_position(const std::array<float, 3> &position);
+  void set_light_color(const std::array<float, 3> &color);
+
+  // Uploads the block if anything changed since the last upload.
+  void upload();
+
+private:
+  GLuint _ubo;
+  FrameUniformsData _data;
+  bool _dirty;
+};
+
+} // namespace darparu::renderer
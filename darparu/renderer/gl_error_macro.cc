@@ -1,5 +1,11 @@
 #include "darparu/renderer/gl_error_macro.h"
 #include <GL/glew.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 namespace darparu::renderer {
 
@@ -26,4 +32,77 @@ const char *glErrorString(GLenum err) {
   }
 }
 
+static bool debug_output_enabled = false;
+// The first error reported by the debug callback since the last check.
+static std::string pending_error;
+
+static const char *debug_severity_string(GLenum severity) {
+  switch (severity) {
+  case GL_DEBUG_SEVERITY_HIGH:
+    return "high";
+  case GL_DEBUG_SEVERITY_MEDIUM:
+    return "medium";
+  case GL_DEBUG_SEVERITY_LOW:
+    return "low";
+  default:
+    return "notification";
+  }
+}
+
+static void GLAPIENTRY debug_callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                      const GLchar *message, const void *user_param) {
+  // Exceptions must not unwind through the driver, so errors are only recorded here and thrown by check_gl_error.
+#ifdef DARPARU_GL_CHECK_ERRORS
+  if (type == GL_DEBUG_TYPE_ERROR) {
+    if (pending_error.empty())
+      pending_error.assign(message, length >= 0 ? static_cast<size_t>(length) : std::strlen(message));
+    return;
+  }
+#endif
+  std::cerr << "OpenGL debug (" << debug_severity_string(severity) << ", id " << id << "): " << message << std::endl;
+}
+
+void check_gl_error(const char *file, int line, const char *call) {
+  std::string error;
+  if (debug_output_enabled) {
+    if (pending_error.empty())
+      return;
+    error.swap(pending_error);
+  } else {
+    GLenum err = glGetError();
+    if (err == GL_NO_ERROR)
+      return;
+    error = glErrorString(err);
+  }
+  std::ostringstream oss;
+  oss << "OpenGL error: " << error << " in file " << file << " at line " << line << " after calling " << call;
+  throw std::runtime_error(oss.str());
+}
+
+bool gl_debug_output_requested() {
+  if (const char *value = std::getenv("DARPARU_GL_DEBUG"))
+    return std::strcmp(value, "0") != 0;
+#ifdef DARPARU_GL_CHECK_ERRORS
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool enable_gl_debug_output() {
+  // Debug output is core since 4.3, which macOS doesn't provide, so GL_CALL keeps using glGetError there.
+  if (!GLEW_VERSION_4_3 && !GLEW_KHR_debug)
+    return false;
+  glEnable(GL_DEBUG_OUTPUT);
+  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glDebugMessageCallback(debug_callback, nullptr);
+  glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+  // Errors raised before the callback was installed, e.g. during glewInit, are not the next call's fault.
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  pending_error.clear();
+  debug_output_enabled = true;
+  return true;
+}
+
 } // namespace darparu::renderer
\ No newline at end of file
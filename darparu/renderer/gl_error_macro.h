@@ -1,21 +1,37 @@
 #pragma once
 #include <GL/glew.h>
-#include <sstream>
 
 namespace darparu::renderer {
 
+// GL_CALL checks for errors after the call unless NDEBUG is defined, in which case it compiles down to just the call.
+// Define DARPARU_GL_CHECK_ERRORS to keep the checks in optimised builds.
+#if !defined(NDEBUG) && !defined(DARPARU_GL_CHECK_ERRORS)
+#define DARPARU_GL_CHECK_ERRORS
+#endif
+
+#ifdef DARPARU_GL_CHECK_ERRORS
 #define GL_CALL(cmd)                                                                                                   \
   {                                                                                                                    \
     cmd;                                                                                                               \
-    GLenum err = glGetError();                                                                                         \
-    if (err != GL_NO_ERROR) {                                                                                          \
-      std::ostringstream oss;                                                                                          \
-      oss << "OpenGL error: " << glErrorString(err) << " in file " << __FILE__ << " at line " << __LINE__              \
-          << " after calling " #cmd;                                                                                   \
-      throw std::runtime_error(oss.str());                                                                             \
-    }                                                                                                                  \
+    ::darparu::renderer::check_gl_error(__FILE__, __LINE__, #cmd);                                                     \
   }
+#else
+#define GL_CALL(cmd)                                                                                                   \
+  { cmd; }
+#endif
 
 const char *glErrorString(GLenum err);
 
-} // namespace darparu::renderer
\ No newline at end of file
+// Throws if the last call raised an error. With debug output enabled this only reads what the synchronous callback
+// recorded, otherwise it falls back to glGetError, which costs a round trip to the driver.
+void check_gl_error(const char *file, int line, const char *call);
+
+// Whether to create a debug context and install the debug output callback. Defaults to whether GL_CALL checks errors,
+// the DARPARU_GL_DEBUG environment variable overrides it at runtime ("0" to disable, anything else to enable).
+bool gl_debug_output_requested();
+
+// Installs a synchronous KHR_debug callback on the current context. Errors are reported by the next GL_CALL with its
+// source location, other messages are logged to std::cerr. Returns false if the context doesn't support debug output.
+bool enable_gl_debug_output();
+
+} // namespace darparu::renderer
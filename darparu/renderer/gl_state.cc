@@ -0,0 +1,215 @@
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+
+namespace darparu::renderer {
+
+static int buffer_index(GLenum target) {
+  switch (target) {
+  case GL_ARRAY_BUFFER:
+    return 0;
+  case GL_ELEMENT_ARRAY_BUFFER:
+    return 1;
+  case GL_UNIFORM_BUFFER:
+    return 2;
+  case GL_PIXEL_PACK_BUFFER:
+    return 3;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return 4;
+  case GL_COPY_READ_BUFFER:
+    return 5;
+  case GL_COPY_WRITE_BUFFER:
+    return 6;
+  default:
+    return -1;
+  }
+}
+
+static int capability_index(GLenum capability) {
+  switch (capability) {
+  case GL_BLEND:
+    return 0;
+  case GL_DEPTH_TEST:
+    return 1;
+  case GL_CULL_FACE:
+    return 2;
+  case GL_SCISSOR_TEST:
+    return 3;
+  default:
+    return -1;
+  }
+}
+
+GlState::GlState() { invalidate(); }
+
+void GlState::invalidate() {
+  _program = UNKNOWN;
+  _vertex_array = UNKNOWN;
+  _buffers.fill(UNKNOWN);
+  _active_texture_unit = UNKNOWN;
+  _textures.fill(UNKNOWN);
+  _draw_framebuffer = UNKNOWN;
+  _read_framebuffer = UNKNOWN;
+  _capabilities.fill(-1);
+  _blend_function = {GL_NONE, GL_NONE};
+  _depth_function = GL_NONE;
+  _depth_mask = -1;
+}
+
+bool GlState::record(bool changed) {
+  if (changed)
+    ++_counters.issued;
+  else
+    ++_counters.skipped;
+  return changed;
+}
+
+void GlState::use_program(GLuint program) {
+  if (record(_program != program)) {
+    glUseProgram(program);
+    _program = program;
+  }
+}
+
+void GlState::bind_vertex_array(GLuint vertex_array) {
+  if (record(_vertex_array != vertex_array)) {
+    glBindVertexArray(vertex_array);
+    _vertex_array = vertex_array;
+    // The element array buffer binding is part of the vertex array's state.
+    _buffers[buffer_index(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+  }
+}
+
+void GlState::bind_buffer(GLenum target, GLuint buffer) {
+  int index = buffer_index(target);
+  if (index < 0) {
+    record(true);
+    glBindBuffer(target, buffer);
+  } else if (record(_buffers[index] != buffer)) {
+    glBindBuffer(target, buffer);
+    _buffers[index] = buffer;
+  }
+}
+
+void GlState::bind_texture(GLuint unit, GLenum target, GLuint texture) {
+  if (record(_active_texture_unit != unit)) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    _active_texture_unit = unit;
+  }
+  if (target != GL_TEXTURE_2D || unit >= TEXTURE_UNITS) {
+    record(true);
+    glBindTexture(target, texture);
+  } else if (record(_textures[unit] != texture)) {
+    glBindTexture(target, texture);
+    _textures[unit] = texture;
+  }
+}
+
+void GlState::bind_framebuffer(GLenum target, GLuint framebuffer) {
+  bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+  bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+  if (record((draw && _draw_framebuffer != framebuffer) || (read && _read_framebuffer != framebuffer))) {
+    glBindFramebuffer(target, framebuffer);
+    if (draw)
+      _draw_framebuffer = framebuffer;
+    if (read)
+      _read_framebuffer = framebuffer;
+  }
+}
+
+void GlState::set_enabled(GLenum capability, bool enabled) {
+  int index = capability_index(capability);
+  if (index >= 0) {
+    if (!record(_capabilities[index] != static_cast<int>(enabled)))
+      return;
+    _capabilities[index] = enabled;
+  } else {
+    record(true);
+  }
+  if (enabled)
+    glEnable(capability);
+  else
+    glDisable(capability);
+}
+
+void GlState::blend_function(GLenum source, GLenum destination) {
+  if (record(_blend_function[0] != source || _blend_function[1] != destination)) {
+    glBlendFunc(source, destination);
+    _blend_function = {source, destination};
+  }
+}
+
+void GlState::depth_function(GLenum function) {
+  if (record(_depth_function != function)) {
+    glDepthFunc(function);
+    _depth_function = function;
+  }
+}
+
+void GlState::depth_mask(bool enabled) {
+  if (record(_depth_mask != static_cast<int>(enabled))) {
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    _depth_mask = enabled;
+  }
+}
+
+void GlState::count_draw(GLenum mode, size_t count, size_t instances) {
+  ++_counters.draw_calls;
+  size_t triangles = 0;
+  if (mode == GL_TRIANGLES)
+    triangles = count / 3;
+  else if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && count >= 3)
+    triangles = count - 2;
+  _counters.triangles += triangles * instances;
+}
+
+// Deleting a bound object reverts the binding to zero, which the shadowed state has to follow since names are reused.
+
+void GlState::delete_program(GLuint program) {
+  glDeleteProgram(program);
+  if (_program == program)
+    _program = 0;
+}
+
+void GlState::delete_vertex_array(GLuint vertex_array) {
+  glDeleteVertexArrays(1, &vertex_array);
+  if (_vertex_array == vertex_array) {
+    _vertex_array = 0;
+    _buffers[buffer_index(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+  }
+}
+
+void GlState::delete_buffer(GLuint buffer) {
+  glDeleteBuffers(1, &buffer);
+  memory_tracker().release(MemoryKind::buffer, buffer);
+  for (auto &bound : _buffers)
+    if (bound == buffer)
+      bound = 0;
+}
+
+void GlState::delete_texture(GLuint texture) {
+  glDeleteTextures(1, &texture);
+  memory_tracker().release(MemoryKind::texture, texture);
+  for (auto &bound : _textures)
+    if (bound == texture)
+      bound = 0;
+}
+
+void GlState::delete_renderbuffer(GLuint renderbuffer) {
+  glDeleteRenderbuffers(1, &renderbuffer);
+  memory_tracker().release(MemoryKind::renderbuffer, renderbuffer);
+}
+
+void GlState::delete_framebuffer(GLuint framebuffer) {
+  glDeleteFramebuffers(1, &framebuffer);
+  if (_draw_framebuffer == framebuffer)
+    _draw_framebuffer = 0;
+  if (_read_framebuffer == framebuffer)
+    _read_framebuffer = 0;
+}
+
+GlState &gl_state() {
+  static GlState state;
+  return state;
+}
+
+} // namespace darparu::renderer
@@ -0,0 +1,74 @@
+#pragma once
+#include <GL/glew.h>
+#include <array>
+#include <cstddef>
+
+namespace darparu::renderer {
+
+struct GlStateCounters {
+  size_t issued = 0;
+  size_t skipped = 0;
+  size_t draw_calls = 0;
+  size_t triangles = 0;
+};
+
+// Shadows the GL binding and capability state of the current context so redundant calls are never issued. All binds in
+// the renderer must go through it, and objects must be deleted through it because GL recycles names.
+class GlState {
+public:
+  GlState();
+
+  void use_program(GLuint program);
+  void bind_vertex_array(GLuint vertex_array);
+  void bind_buffer(GLenum target, GLuint buffer);
+  void bind_texture(GLuint unit, GLenum target, GLuint texture);
+  void bind_framebuffer(GLenum target, GLuint framebuffer);
+
+  void set_enabled(GLenum capability, bool enabled);
+  void blend_function(GLenum source, GLenum destination);
+  void depth_function(GLenum function);
+  void depth_mask(bool enabled);
+
+  // Counts a draw call of count vertices or indices, for the frame statistics.
+  void count_draw(GLenum mode, size_t count, size_t instances = 1);
+
+  void delete_program(GLuint program);
+  void delete_vertex_array(GLuint vertex_array);
+  void delete_buffer(GLuint buffer);
+  void delete_texture(GLuint texture);
+  void delete_renderbuffer(GLuint renderbuffer);
+  void delete_framebuffer(GLuint framebuffer);
+
+  // Forgets all shadowed state, for when GL state was changed behind the tracker's back.
+  void invalidate();
+
+  const GlStateCounters &counters() const { return _counters; }
+  void reset_counters() { _counters = {}; }
+
+private:
+  static constexpr GLuint UNKNOWN = ~0u;
+  static constexpr size_t BUFFER_TARGETS = 7;
+  static constexpr size_t TEXTURE_UNITS = 16;
+  static constexpr size_t CAPABILITIES = 4;
+
+  GLuint _program;
+  GLuint _vertex_array;
+  std::array<GLuint, BUFFER_TARGETS> _buffers;
+  GLuint _active_texture_unit;
+  std::array<GLuint, TEXTURE_UNITS> _textures;
+  GLuint _draw_framebuffer;
+  GLuint _read_framebuffer;
+  std::array<int, CAPABILITIES> _capabilities;
+  std::array<GLenum, 2> _blend_function;
+  GLenum _depth_function;
+  int _depth_mask;
+
+  GlStateCounters _counters;
+
+  bool record(bool changed);
+};
+
+// The state tracker of the renderer's (single) GL context.
+GlState &gl_state();
+
+} // namespace darparu::renderer
@@ -0,0 +1,100 @@
+#include "darparu/renderer/gpu_profiler.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace darparu::renderer {
+
+GpuProfiler::GpuProfiler(size_t frames_in_flight) : _frames(frames_in_flight) {
+  if (frames_in_flight == 0)
+    throw std::invalid_argument("GPU profiler needs at least one frame in flight");
+}
+
+GpuProfiler::~GpuProfiler() { release(); }
+
+void GpuProfiler::release() {
+  for (auto &frame : _frames) {
+    if (!frame.queries.empty())
+      glDeleteQueries(frame.queries.size(), frame.queries.data());
+    frame = Frame();
+  }
+  _in_frame = false;
+}
+
+void GpuProfiler::begin_frame() {
+  _in_frame = _enabled;
+  if (!_enabled)
+    return;
+  Frame &frame = _frames[_frame % _frames.size()];
+  if (!frame.zones.empty()) {
+    GLint available = GL_FALSE;
+    GL_CALL(glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (available) {
+      _timings.clear();
+      for (const auto &zone : frame.zones) {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(zone.begin_query, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(zone.end_query, GL_QUERY_RESULT, &end);
+        _timings.push_back({zone.name, zone.owner, static_cast<double>(end - begin) * 1e-6});
+      }
+    } else {
+      ++_dropped_frames;
+    }
+  }
+  frame.zones.clear();
+  frame.used_queries = 0;
+}
+
+void GpuProfiler::end_frame() {
+  if (_in_frame)
+    ++_frame;
+  _in_frame = false;
+}
+
+GLuint GpuProfiler::next_query(Frame &frame) {
+  if (frame.used_queries == frame.queries.size()) {
+    const size_t grown = std::max<size_t>(16, 2 * frame.queries.size());
+    frame.queries.resize(grown);
+    glGenQueries(grown - frame.used_queries, frame.queries.data() + frame.used_queries);
+  }
+  return frame.queries[frame.used_queries++];
+}
+
+size_t GpuProfiler::begin(const char *name, const void *owner) {
+  if (!_in_frame)
+    return 0;
+  Frame &frame = _frames[_frame % _frames.size()];
+  const GLuint begin_query = next_query(frame);
+  const GLuint end_query = next_query(frame);
+  GL_CALL(glQueryCounter(begin_query, GL_TIMESTAMP));
+  frame.zones.push_back({name, owner, begin_query, end_query});
+  return frame.zones.size() - 1;
+}
+
+void GpuProfiler::end(size_t zone) {
+  if (!_in_frame)
+    return;
+  Frame &frame = _frames[_frame % _frames.size()];
+  GL_CALL(glQueryCounter(frame.zones[zone].end_query, GL_TIMESTAMP));
+  frame.last_query = frame.zones[zone].end_query;
+}
+
+double GpuProfiler::milliseconds(const char *name) const {
+  double sum = 0.0;
+  for (const auto &timing : _timings)
+    if (std::strcmp(timing.name, name) == 0)
+      sum += timing.milliseconds;
+  return sum;
+}
+
+double GpuProfiler::milliseconds(const void *owner) const {
+  double sum = 0.0;
+  for (const auto &timing : _timings)
+    if (timing.owner == owner)
+      sum += timing.milliseconds;
+  return sum;
+}
+
+} // namespace darparu::renderer
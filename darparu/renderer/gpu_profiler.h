@@ -0,0 +1,91 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+namespace darparu::renderer {
+
+struct GpuTiming {
+  // A string literal naming the zone, e.g. the pass or "draw".
+  const char *name;
+  // What the zone measured, e.g. a renderable, or nullptr.
+  const void *owner;
+  double milliseconds;
+};
+
+// Measures GPU time of (possibly nested) zones with timestamp queries. Queries are kept in a ring of frames and read
+// back frames_in_flight frames later, so results never stall the pipeline and lag the current frame by that much.
+class GpuProfiler {
+public:
+  explicit GpuProfiler(size_t frames_in_flight = 4);
+  ~GpuProfiler();
+
+  GpuProfiler(const GpuProfiler &) = delete;
+  GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+  // Deletes the queries and discards pending results, for owners that outlive their GL context. Profiling can resume
+  // afterwards with new queries.
+  void release();
+
+  void set_enabled(bool enabled) { _enabled = enabled; }
+  bool enabled() const { return _enabled; }
+
+  // Collects the results of the frame that last used this frame's queries.
+  void begin_frame();
+  void end_frame();
+
+  // Returns a handle for end, zones can nest but not overlap.
+  size_t begin(const char *name, const void *owner = nullptr);
+  void end(size_t zone);
+
+  class Scope {
+  public:
+    Scope(GpuProfiler *profiler, const char *name, const void *owner = nullptr)
+        : _profiler(profiler), _zone(profiler ? profiler->begin(name, owner) : 0) {}
+    ~Scope() {
+      if (_profiler)
+        _profiler->end(_zone);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    GpuProfiler *_profiler;
+    size_t _zone;
+  };
+
+  // Zones of the most recent frame whose results came back, in the order they began.
+  const std::vector<GpuTiming> &timings() const { return _timings; }
+  // Sums of those zones by name or by owner.
+  double milliseconds(const char *name) const;
+  double milliseconds(const void *owner) const;
+  // Frames whose results were still pending when their queries were needed again, so were discarded.
+  size_t dropped_frames() const { return _dropped_frames; }
+
+private:
+  struct Zone {
+    const char *name;
+    const void *owner;
+    GLuint begin_query;
+    GLuint end_query;
+  };
+
+  struct Frame {
+    std::vector<GLuint> queries;
+    std::vector<Zone> zones;
+    size_t used_queries = 0;
+    // Results become available in the order queries were issued.
+    GLuint last_query = 0;
+  };
+
+  bool _enabled = false;
+  std::vector<Frame> _frames;
+  size_t _frame = 0;
+  bool _in_frame = false;
+  std::vector<GpuTiming> _timings;
+  size_t _dropped_frames = 0;
+
+  GLuint next_query(Frame &frame);
+};
+
+} // namespace darparu::renderer
@@ -0,0 +1,90 @@
+#include "darparu/renderer/hud.h"
+#include "darparu/renderer/memory_tracker.h"
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace darparu::renderer {
+
+static constexpr float MARGIN = 8.0f;
+static constexpr std::array<float, 3> TEXT_COLOR = {1.0f, 1.0f, 1.0f};
+static constexpr std::array<float, 3> OVER_BUDGET_COLOR = {1.0f, 0.4f, 0.3f};
+
+Hud::Hud(const Renderer &renderer, const std::filesystem::path &font_path, unsigned int pixel_height,
+         double refresh_seconds)
+    : _renderer(renderer), _text(font_path, pixel_height),
+      _refresh_interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(refresh_seconds))),
+      _last_refresh(std::chrono::steady_clock::now()) {}
+
+void Hud::set_visible(bool visible) {
+  if (visible == _visible)
+    return;
+  _visible = visible;
+  mark_dirty();
+}
+
+std::optional<std::filesystem::path> Hud::find_font() {
+  if (const char *path = std::getenv("DARPARU_HUD_FONT"))
+    return std::filesystem::path(path);
+  for (const char *path : {"/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+                           "/usr/share/fonts/dejavu-sans-mono-fonts/DejaVuSansMono.ttf",
+                           "/usr/share/fonts/TTF/DejaVuSansMono.ttf", "/System/Library/Fonts/Menlo.ttc",
+                           "C:/Windows/Fonts/consola.ttf"}) {
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+      return std::filesystem::path(path);
+  }
+  return std::nullopt;
+}
+
+void Hud::refresh(double elapsed_seconds) {
+  const auto summary = _renderer.frame_stats().summary();
+  const auto &counters = _renderer.gl_state_counters();
+  const auto &profiler = _renderer.gpu_profiler();
+
+  std::ostringstream lines[5];
+  for (auto &line : lines)
+    line << std::fixed << std::setprecision(1);
+  lines[0] << "FPS " << _frames_since_refresh / elapsed_seconds;
+  lines[1] << "CPU ms p50 " << summary.p50_ms << "  p95 " << summary.p95_ms << "  p99 " << summary.p99_ms << "  max "
+           << summary.max_ms;
+  lines[2] << "Draws " << counters.draw_calls << "  triangles " << counters.triangles;
+  if (profiler.enabled())
+    lines[3] << std::setprecision(2) << "GPU ms frame " << profiler.milliseconds("frame") << "  refraction "
+             << profiler.milliseconds("refraction pass") << "  main " << profiler.milliseconds("main pass");
+  else
+    lines[3] << "GPU profiler off";
+  const auto &memory = memory_tracker().total();
+  lines[4] << "Memory MiB GPU " << memory.gpu_bytes / (1024.0 * 1024.0) << "  host "
+           << memory.host_bytes / (1024.0 * 1024.0);
+
+  _text.clear();
+  const auto [width, height] = _renderer.framebuffer_size();
+  _text.set_screen_size(width, height);
+  float y = MARGIN;
+  for (size_t i = 0; i < std::size(lines); ++i) {
+    const bool over_budget = i == 1 && summary.p95_ms > _renderer.frame_stats().budget();
+    _text.add(lines[i].str(), MARGIN, y, over_budget ? OVER_BUDGET_COLOR : TEXT_COLOR);
+    y += _text.line_height();
+  }
+}
+
+void Hud::submit(RenderQueue &queue, RenderPass pass) {
+  if (!_visible || pass != RenderPass::main)
+    return;
+  ++_frames_since_refresh;
+  const auto now = std::chrono::steady_clock::now();
+  // The first frame refreshes straight away, on demand rendering may not draw another for a while.
+  if (!_refreshed || now - _last_refresh >= _refresh_interval) {
+    refresh(std::chrono::duration<double>(now - _last_refresh).count());
+    _last_refresh = now;
+    _frames_since_refresh = 0;
+    _refreshed = true;
+  }
+  // The text's own draw is queued, so its shader and vertex array take part in sorting.
+  _text.submit(queue, pass);
+}
+
+} // namespace darparu::renderer
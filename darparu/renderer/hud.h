@@ -0,0 +1,44 @@
+#pragma once
+#include "darparu/renderer/entities/text.h"
+#include "darparu/renderer/renderable.h"
+#include "darparu/renderer/renderer.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+
+namespace darparu::renderer {
+
+// On screen overlay of the frame rate, frame time percentiles, draw calls, triangles, GPU pass times when the GPU
+// profiler is enabled, and the tracked GPU and host memory. The text is refreshed from the renderer's statistics a few
+// times per second, on frames that are drawn anyway. Add it to the renderer without reflection.
+class Hud : public Renderable {
+public:
+  Hud(const Renderer &renderer, const std::filesystem::path &font_path, unsigned int pixel_height = 16,
+      double refresh_seconds = 0.25);
+
+  void set_model(const std::array<float, 16> &model) {}
+  void set_visible(bool visible);
+  bool visible() const { return _visible; }
+
+  void draw() { _text.draw(); }
+  void submit(RenderQueue &queue, RenderPass pass);
+
+  // The DARPARU_HUD_FONT environment variable, else the first of a few common system fonts that exists.
+  static std::optional<std::filesystem::path> find_font();
+
+private:
+  const Renderer &_renderer;
+  entities::Text _text;
+  bool _visible = true;
+
+  std::chrono::steady_clock::duration _refresh_interval;
+  std::chrono::steady_clock::time_point _last_refresh;
+  size_t _frames_since_refresh = 0;
+  bool _refreshed = false;
+
+  void refresh(double elapsed_seconds);
+};
+
+} // namespace darparu::renderer
@@ -1,16 +1,22 @@
 #include "darparu/renderer/io_control.h"
+#include "darparu/profile.h"
 #include "darparu/renderer/gl_error_macro.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 namespace darparu::renderer {
 
-bool IoControl::update() {
+bool IoControl::update(double wait_seconds) {
+  DARPARU_PROFILE_ZONE("IoControl::update");
   _event = false;
   _last_mouse_position_in_pixels[0] = _mouse_position_in_pixels[0];
   _last_mouse_position_in_pixels[1] = _mouse_position_in_pixels[1];
   _scroll_offset = 0.0;
-  GL_CALL(glfwPollEvents());
+  if (wait_seconds > 0.0) {
+    GL_CALL(glfwWaitEventsTimeout(wait_seconds));
+  } else {
+    GL_CALL(glfwPollEvents());
+  }
   _mouse_position_change_in_pixels[0] = _mouse_position_in_pixels[0] - _last_mouse_position_in_pixels[0];
   _mouse_position_change_in_pixels[1] = _mouse_position_in_pixels[1] - _last_mouse_position_in_pixels[1];
   return _event;
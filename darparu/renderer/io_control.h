@@ -6,7 +6,8 @@ class IoControl {
 public:
   IoControl() = default;
   ~IoControl() = default;
-  bool update();
+  // Handles pending events, first waiting up to wait_seconds for one to arrive. Returns whether there were any.
+  virtual bool update(double wait_seconds = 0.0);
   void key_event(int key, int scancode, int action, int mods);
   void mouse_button_event(int button, int action, int mods);
   void cursor_position_event(double xpos, double ypos);
@@ -0,0 +1,60 @@
+#pragma once
+#include "darparu/renderer/io_control.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+namespace darparu::renderer {
+
+struct CameraKeyframe {
+  std::array<float, 3> position;
+  std::array<float, 2> radians;
+  float zoom = 1.0f;
+};
+
+// Ignores input and moves the camera along keyframes spread evenly over a fixed number of frames, interpolating
+// linearly between them, then asks the renderer to close.
+class CameraPathIoControl : public IoControl {
+public:
+  CameraPathIoControl(std::vector<CameraKeyframe> keyframes, size_t frames)
+      : _keyframes(std::move(keyframes)), _frames(frames) {
+    if (_keyframes.empty() || _frames == 0)
+      throw std::invalid_argument("Camera path needs at least one keyframe and one frame");
+  }
+
+  virtual ~CameraPathIoControl() = default;
+
+  bool update(double wait_seconds = 0.0) override {
+    IoControl::update();
+    return true;
+  }
+
+  bool control(std::array<float, 3> &camera_position, std::array<float, 2> &camera_radians, float &zoom) override {
+    if (_frame >= _frames) {
+      _escape_pressed = true;
+      return false;
+    }
+    const float t = _frames > 1 ? static_cast<float>(_frame) / static_cast<float>(_frames - 1) : 0.0f;
+    const float along = t * static_cast<float>(_keyframes.size() - 1);
+    const size_t index = std::min(static_cast<size_t>(along), _keyframes.size() - 1);
+    const CameraKeyframe &from = _keyframes[index];
+    const CameraKeyframe &to = _keyframes[std::min(index + 1, _keyframes.size() - 1)];
+    const float s = along - static_cast<float>(index);
+    for (size_t i = 0; i < 3; ++i)
+      camera_position[i] = from.position[i] + s * (to.position[i] - from.position[i]);
+    for (size_t i = 0; i < 2; ++i)
+      camera_radians[i] = from.radians[i] + s * (to.radians[i] - from.radians[i]);
+    zoom = from.zoom + s * (to.zoom - from.zoom);
+    ++_frame;
+    return true;
+  }
+
+  size_t frame() const { return _frame; }
+
+private:
+  std::vector<CameraKeyframe> _keyframes;
+  size_t _frames;
+  size_t _frame = 0;
+};
+} // namespace darparu::renderer
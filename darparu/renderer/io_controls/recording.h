@@ -0,0 +1,125 @@
+#pragma once
+#include "darparu/renderer/io_control.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace darparu::renderer {
+
+// A camera state the control produced, and when, in seconds since recording started.
+struct CameraRecord {
+  double seconds;
+  std::array<float, 3> position;
+  std::array<float, 2> radians;
+  float zoom;
+};
+
+// Recordings are a magic and version header followed by packed 32 byte records in native (little endian on all
+// supported platforms) byte order.
+constexpr char CAMERA_RECORDING_MAGIC[4] = {'D', 'P', 'C', 'R'};
+constexpr std::uint32_t CAMERA_RECORDING_VERSION = 1;
+constexpr size_t CAMERA_RECORD_SIZE = sizeof(double) + 6 * sizeof(float);
+
+// Wraps a control, e.g. RecordingIoControl<Simple3DIoControl>, writing every camera state it produces to a file. The
+// initial state is always recorded, later ones only when the control changed the camera, so idle time is not recorded.
+template <typename Control> class RecordingIoControl : public Control {
+public:
+  template <typename... Args>
+  RecordingIoControl(const std::filesystem::path &path, Args &&...args)
+      : Control(std::forward<Args>(args)...), _file(path, std::ios::binary),
+        _start(std::chrono::steady_clock::now()) {
+    if (!_file)
+      throw std::runtime_error("Could not create camera recording " + path.string());
+    _file.write(CAMERA_RECORDING_MAGIC, sizeof(CAMERA_RECORDING_MAGIC));
+    _file.write(reinterpret_cast<const char *>(&CAMERA_RECORDING_VERSION), sizeof(CAMERA_RECORDING_VERSION));
+  }
+
+  virtual ~RecordingIoControl() = default;
+
+  bool control(std::array<float, 3> &camera_position, std::array<float, 2> &camera_radians, float &zoom) override {
+    const bool changed = Control::control(camera_position, camera_radians, zoom);
+    if (changed || _records == 0)
+      write({std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count(), camera_position,
+             camera_radians, zoom});
+    return changed;
+  }
+
+  size_t records() const { return _records; }
+
+private:
+  std::ofstream _file;
+  std::chrono::steady_clock::time_point _start;
+  size_t _records = 0;
+
+  void write(const CameraRecord &record) {
+    char bytes[CAMERA_RECORD_SIZE];
+    std::memcpy(bytes, &record.seconds, sizeof(double));
+    std::memcpy(bytes + sizeof(double), record.position.data(), 3 * sizeof(float));
+    std::memcpy(bytes + sizeof(double) + 3 * sizeof(float), record.radians.data(), 2 * sizeof(float));
+    std::memcpy(bytes + sizeof(double) + 5 * sizeof(float), &record.zoom, sizeof(float));
+    _file.write(bytes, sizeof(bytes));
+    ++_records;
+  }
+};
+
+// Replays a recording frame locked: each update moves the camera to the next recorded state regardless of the time it
+// was recorded at, so every run renders the exact same sequence of frames. Asks the renderer to close at the end. Use
+// with RedrawMode::continuous and no frame rate limit for timing.
+class ReplayIoControl : public IoControl {
+public:
+  explicit ReplayIoControl(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+      throw std::runtime_error("Could not open camera recording " + path.string());
+    char magic[sizeof(CAMERA_RECORDING_MAGIC)];
+    std::uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (!file || std::memcmp(magic, CAMERA_RECORDING_MAGIC, sizeof(magic)) != 0 ||
+        version != CAMERA_RECORDING_VERSION)
+      throw std::runtime_error("Invalid camera recording " + path.string());
+    for (char bytes[CAMERA_RECORD_SIZE]; file.read(bytes, sizeof(bytes));) {
+      CameraRecord &record = _records.emplace_back();
+      std::memcpy(&record.seconds, bytes, sizeof(double));
+      std::memcpy(record.position.data(), bytes + sizeof(double), 3 * sizeof(float));
+      std::memcpy(record.radians.data(), bytes + sizeof(double) + 3 * sizeof(float), 2 * sizeof(float));
+      std::memcpy(&record.zoom, bytes + sizeof(double) + 5 * sizeof(float), sizeof(float));
+    }
+    if (_records.empty())
+      throw std::runtime_error("Empty camera recording " + path.string());
+  }
+
+  virtual ~ReplayIoControl() = default;
+
+  bool update(double wait_seconds = 0.0) override {
+    IoControl::update();
+    return true;
+  }
+
+  bool control(std::array<float, 3> &camera_position, std::array<float, 2> &camera_radians, float &zoom) override {
+    if (_frame >= _records.size()) {
+      _escape_pressed = true;
+      return false;
+    }
+    const CameraRecord &record = _records[_frame++];
+    camera_position = record.position;
+    camera_radians = record.radians;
+    zoom = record.zoom;
+    return true;
+  }
+
+  size_t frame() const { return _frame; }
+  const std::vector<CameraRecord> &records() const { return _records; }
+
+private:
+  std::vector<CameraRecord> _records;
+  size_t _frame = 0;
+};
+
+} // namespace darparu::renderer
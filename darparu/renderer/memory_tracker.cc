@@ -0,0 +1,91 @@
+#include "darparu/renderer/memory_tracker.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace darparu::renderer {
+
+static double mebibytes(size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+void MemoryTracker::track(MemoryKind kind, GLuint object, size_t bytes, const void *owner, std::string name) {
+  auto [it, inserted] = _gpu.try_emplace({kind, object}, Allocation{owner, std::move(name), bytes});
+  if (!inserted) {
+    _total.gpu_bytes -= it->second.bytes;
+    it->second = {owner, std::move(name), bytes};
+  }
+  _total.gpu_bytes += bytes;
+}
+
+void MemoryTracker::release(MemoryKind kind, GLuint object) {
+  auto it = _gpu.find({kind, object});
+  if (it == _gpu.end())
+    return;
+  _total.gpu_bytes -= it->second.bytes;
+  _gpu.erase(it);
+}
+
+void MemoryTracker::track_host(const void *owner, std::string name, std::string label, size_t bytes) {
+  auto [it, inserted] = _host.try_emplace({owner, std::move(label)}, Allocation{owner, std::move(name), bytes});
+  if (!inserted) {
+    _total.host_bytes -= it->second.bytes;
+    it->second.bytes = bytes;
+  }
+  _total.host_bytes += bytes;
+}
+
+void MemoryTracker::release_host(const void *owner) {
+  // Keys are ordered by owner first, so an owner's allocations are contiguous.
+  auto it = _host.lower_bound({owner, std::string()});
+  while (it != _host.end() && it->first.first == owner) {
+    _total.host_bytes -= it->second.bytes;
+    it = _host.erase(it);
+  }
+}
+
+MemoryUsage MemoryTracker::usage(const void *owner) const {
+  MemoryUsage usage;
+  for (const auto &[key, allocation] : _gpu)
+    if (allocation.owner == owner)
+      usage.gpu_bytes += allocation.bytes;
+  for (auto it = _host.lower_bound({owner, std::string()}); it != _host.end() && it->first.first == owner; ++it)
+    usage.host_bytes += it->second.bytes;
+  return usage;
+}
+
+std::vector<OwnerMemory> MemoryTracker::owners() const {
+  std::map<const void *, OwnerMemory> by_owner;
+  for (const auto &[key, allocation] : _gpu) {
+    auto it = by_owner.try_emplace(allocation.owner, OwnerMemory{allocation.owner, allocation.name, {}}).first;
+    it->second.usage.gpu_bytes += allocation.bytes;
+  }
+  for (const auto &[key, allocation] : _host) {
+    auto it = by_owner.try_emplace(allocation.owner, OwnerMemory{allocation.owner, allocation.name, {}}).first;
+    it->second.usage.host_bytes += allocation.bytes;
+  }
+  std::vector<OwnerMemory> owners;
+  for (auto &[pointer, owner] : by_owner)
+    owners.push_back(std::move(owner));
+  std::sort(owners.begin(), owners.end(), [](const OwnerMemory &a, const OwnerMemory &b) {
+    return a.usage.gpu_bytes + a.usage.host_bytes > b.usage.gpu_bytes + b.usage.host_bytes;
+  });
+  return owners;
+}
+
+std::ostream &operator<<(std::ostream &stream, const MemoryTracker &tracker) {
+  const auto flags = stream.flags();
+  const auto precision = stream.precision();
+  stream << std::fixed << std::setprecision(2) << "Memory: GPU " << mebibytes(tracker.total().gpu_bytes)
+         << "MiB, host " << mebibytes(tracker.total().host_bytes) << "MiB";
+  for (const auto &owner : tracker.owners())
+    stream << "\n  " << owner.name << " (" << owner.owner << "): GPU " << mebibytes(owner.usage.gpu_bytes)
+           << "MiB, host " << mebibytes(owner.usage.host_bytes) << "MiB";
+  stream.flags(flags);
+  stream.precision(precision);
+  return stream;
+}
+
+MemoryTracker &memory_tracker() {
+  static MemoryTracker tracker;
+  return tracker;
+}
+
+} // namespace darparu::renderer
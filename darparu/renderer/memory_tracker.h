@@ -0,0 +1,68 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace darparu::renderer {
+
+enum class MemoryKind : std::uint8_t { buffer, texture, renderbuffer };
+
+struct MemoryUsage {
+  size_t gpu_bytes = 0;
+  size_t host_bytes = 0;
+};
+
+struct OwnerMemory {
+  const void *owner;
+  std::string name;
+  MemoryUsage usage;
+};
+
+// Accounts for the GPU memory of buffers, textures and renderbuffers, and the host memory of CPU side copies such as
+// vertex data kept for updates, by owner. GPU sizes are what was requested from GL, drivers may pad them or keep
+// copies of their own.
+class MemoryTracker {
+public:
+  // Sets the size of a GL object, replacing any earlier size.
+  void track(MemoryKind kind, GLuint object, size_t bytes, const void *owner, std::string name);
+  // Forgets a GL object. GlState does this for the objects deleted through it.
+  void release(MemoryKind kind, GLuint object);
+
+  // Sets the size of an owner's host allocation identified by label, replacing any earlier size.
+  void track_host(const void *owner, std::string name, std::string label, size_t bytes);
+  template <typename T>
+  void track_host(const void *owner, std::string name, std::string label, const std::vector<T> &vector) {
+    track_host(owner, std::move(name), std::move(label), vector.capacity() * sizeof(T));
+  }
+  // Forgets all host allocations of an owner.
+  void release_host(const void *owner);
+
+  const MemoryUsage &total() const { return _total; }
+  MemoryUsage usage(const void *owner) const;
+  // Every owner's usage, largest first.
+  std::vector<OwnerMemory> owners() const;
+
+private:
+  struct Allocation {
+    const void *owner;
+    std::string name;
+    size_t bytes;
+  };
+
+  std::map<std::pair<MemoryKind, GLuint>, Allocation> _gpu;
+  std::map<std::pair<const void *, std::string>, Allocation> _host;
+  MemoryUsage _total;
+};
+
+// Prints the totals and each owner's usage in MiB.
+std::ostream &operator<<(std::ostream &stream, const MemoryTracker &tracker);
+
+// The tracker of the renderer's (single) GL context.
+MemoryTracker &memory_tracker();
+
+} // namespace darparu::renderer
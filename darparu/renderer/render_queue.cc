@@ -0,0 +1,80 @@
+#include "darparu/renderer/render_queue.h"
+#include "darparu/renderer/renderable.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace darparu::renderer {
+
+static constexpr std::uint64_t DEPTH_BITS = 24;
+static constexpr std::uint64_t DEPTH_MAX = (std::uint64_t(1) << DEPTH_BITS) - 1;
+
+std::uint64_t RenderQueue::make_key(RenderPass pass, RenderLayer layer, GLuint program, GLuint vertex_array,
+                                    float depth) {
+  const std::uint64_t quantized_depth =
+      static_cast<std::uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(DEPTH_MAX));
+  std::uint64_t key = (static_cast<std::uint64_t>(pass) & 0xf) << 60 | (static_cast<std::uint64_t>(layer) & 0xf) << 56;
+  const std::uint64_t state = (static_cast<std::uint64_t>(program) & 0xffff) << 16 | (vertex_array & 0xffff);
+  if (layer == RenderLayer::opaque)
+    key |= state << DEPTH_BITS | quantized_depth;
+  else
+    key |= (DEPTH_MAX - quantized_depth) << 32 | state;
+  return key;
+}
+
+void RenderQueue::set_camera(const std::array<float, 16> &view, const std::array<float, 16> &projection,
+                             float far_plane, int viewport_height) {
+  _view = view;
+  _projection = projection;
+  _far_plane = far_plane;
+  _viewport_height = viewport_height;
+}
+
+float RenderQueue::depth(const std::array<float, 3> &position) const {
+  // The view matrix looks down -z, so the distance in front of the camera is the negated third row.
+  const float z = _view[8] * position[0] + _view[9] * position[1] + _view[10] * position[2] + _view[11];
+  return -z / _far_plane;
+}
+
+float RenderQueue::screen_radius(const std::array<float, 3> &center, float radius) const {
+  std::array<float, 3> view_center;
+  for (size_t row = 0; row < 3; ++row)
+    view_center[row] = _view[row * 4] * center[0] + _view[row * 4 + 1] * center[1] + _view[row * 4 + 2] * center[2] +
+                       _view[row * 4 + 3];
+  // The clip w row is -z for perspective and 1 for orthographic projections.
+  const float w = _projection[12] * view_center[0] + _projection[13] * view_center[1] +
+                  _projection[14] * view_center[2] + _projection[15];
+  if (w <= 0.0f)
+    return std::numeric_limits<float>::infinity();
+  return radius * std::abs(_projection[5]) / w * 0.5f * static_cast<float>(_viewport_height);
+}
+
+void RenderQueue::submit(RenderPass pass, RenderLayer layer, GLuint program, GLuint vertex_array, float depth,
+                         Renderable *renderable) {
+  _items.push_back({make_key(pass, layer, program, vertex_array, depth), renderable});
+}
+
+void RenderQueue::clear() {
+  _items.clear();
+  ++_frame;
+}
+
+void RenderQueue::sort() {
+  std::sort(_items.begin(), _items.end(), [](const DrawItem &a, const DrawItem &b) { return a.key < b.key; });
+}
+
+void RenderQueue::execute(RenderPass pass, GpuProfiler *profiler) const {
+  const std::uint64_t pass_bits = static_cast<std::uint64_t>(pass) << 60;
+  auto begin = std::lower_bound(_items.begin(), _items.end(), pass_bits,
+                                [](const DrawItem &item, std::uint64_t key) { return item.key < key; });
+  for (auto it = begin; it != _items.end() && (it->key >> 60) == static_cast<std::uint64_t>(pass); ++it) {
+    GpuProfiler::Scope scope(profiler, "draw", it->renderable);
+    it->renderable->draw();
+  }
+}
+
+void Renderable::submit(RenderQueue &queue, RenderPass pass) {
+  queue.submit(pass, RenderLayer::opaque, 0, 0, 0.0f, this);
+}
+
+} // namespace darparu::renderer
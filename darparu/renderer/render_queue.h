@@ -0,0 +1,62 @@
+#pragma once
+#include "darparu/renderer/gpu_profiler.h"
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace darparu::renderer {
+
+class Renderable;
+
+enum class RenderPass : std::uint8_t { refraction, main };
+
+enum class RenderLayer : std::uint8_t { opaque, transparent };
+
+struct DrawItem {
+  std::uint64_t key;
+  Renderable *renderable;
+};
+
+// Collects the draws of a frame and executes them ordered by a 64 bit sort key, from the most significant bits:
+//   pass (4) | layer (4) | opaque: program (16), vertex array (16), depth (24)
+//                        | transparent: inverted depth (24), program (16), vertex array (16)
+// so that within a pass opaque draws are grouped by program and vertex array and then drawn front to back, while
+// transparent draws are drawn back to front.
+class RenderQueue {
+public:
+  static std::uint64_t make_key(RenderPass pass, RenderLayer layer, GLuint program, GLuint vertex_array, float depth);
+
+  void set_camera(const std::array<float, 16> &view, const std::array<float, 16> &projection, float far_plane,
+                  int viewport_height);
+  // Normalized distance of a world position in front of the camera, 0 at the camera and 1 at the far plane.
+  float depth(const std::array<float, 3> &position) const;
+  // Depth of the origin of a (transposed) model matrix.
+  float depth(const std::array<float, 16> &model) const {
+    return depth(std::array<float, 3>{model[3], model[7], model[11]});
+  }
+  // Approximate radius in pixels of a sphere given in world space, infinite when the camera is at or behind its centre.
+  float screen_radius(const std::array<float, 3> &center, float radius) const;
+
+  void submit(RenderPass pass, RenderLayer layer, GLuint program, GLuint vertex_array, float depth,
+              Renderable *renderable);
+  // Starts a new frame, dropping all items.
+  void clear();
+  void sort();
+  // Draws the items of a pass, the queue must be sorted. Each draw is timed when given a profiler.
+  void execute(RenderPass pass, GpuProfiler *profiler = nullptr) const;
+
+  const std::vector<DrawItem> &items() const { return _items; }
+  // Counts calls to clear, for renderables that do per frame work once across passes.
+  std::uint64_t frame() const { return _frame; }
+
+private:
+  std::vector<DrawItem> _items;
+  std::array<float, 16> _view{};
+  std::array<float, 16> _projection{};
+  float _far_plane = 1.0f;
+  int _viewport_height = 1;
+  std::uint64_t _frame = 0;
+};
+
+} // namespace darparu::renderer
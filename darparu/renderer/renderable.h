@@ -1,7 +1,15 @@
 #pragma once
+#include "darparu/renderer/render_queue.h"
 #include <array>
+#include <cstdint>
+#include <optional>
 namespace darparu::renderer {
 
+struct BoundingBox {
+  std::array<float, 3> min;
+  std::array<float, 3> max;
+};
+
 class Renderable {
 public:
   virtual ~Renderable() = default;
@@ -9,10 +17,23 @@ public:
   // Method to render the object
   virtual void draw() = 0;
 
-  // Methods to set transformation matrices
-  virtual void set_view(const std::array<float, 16> &view) = 0;
-  virtual void set_projection(const std::array<float, 16> &projection) = 0;
+  // Method to set the model matrix, view and projection come from the shared Frame uniform block
   virtual void set_model(const std::array<float, 16> &model) = 0;
+
+  // Method to queue the object's draws for a pass, by default a single opaque draw sorted before all others
+  virtual void submit(RenderQueue &queue, RenderPass pass);
+
+  // World space box around where the object samples the camera texture, none if it doesn't sample it at all
+  virtual std::optional<BoundingBox> refraction_bounds() const { return std::nullopt; }
+
+  // Bumped whenever the object's appearance changes, so cached renders of it can tell when they are stale
+  uint64_t revision() const { return _revision; }
+
+protected:
+  void mark_dirty() { ++_revision; }
+
+private:
+  uint64_t _revision = 0;
 };
 
-} // namespace darparu::renderer
\ No newline at end of file
+} // namespace darparu::renderer
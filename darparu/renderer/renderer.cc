@@ -1,8 +1,15 @@
 #include "darparu/renderer/renderer.h"
+#include "darparu/profile.h"
 #include "darparu/renderer/algebra.h"
 #include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
 #include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
 
 static void glfwErrorCallback(int error, const char *description) {
   std::cerr << "GLFW Error: " << error << " - " << description << std::endl;
@@ -11,8 +18,21 @@ static void glfwErrorCallback(int error, const char *description) {
 
 namespace darparu::renderer {
 
-void init() {
+static Backend &current_backend() {
+  static Backend backend = Backend::window;
+  return backend;
+}
+
+void init(Backend backend) {
+  current_backend() = backend;
   glfwSetErrorCallback(glfwErrorCallback);
+  // Without a display there is no window system to create a context with, so fall back to GLFW's null platform and an
+  // EGL context, which on Mesa is surfaceless and runs on llvmpipe without a GPU. EGL goes through libglvnd like GLX,
+  // so the GL functions GLEW loads dispatch to it, unlike an OSMesa context on a glvnd libGL.
+  const bool offscreen_context = backend == Backend::headless && !std::getenv("DISPLAY") &&
+                                 !std::getenv("WAYLAND_DISPLAY");
+  if (offscreen_context)
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
   if (!glfwInit()) {
     throw std::runtime_error("Could not initialize glfw");
   }
@@ -21,6 +41,15 @@ void init() {
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  // Blitting depth from the camera texture needs the window's depth format to match it.
+  glfwWindowHint(GLFW_DEPTH_BITS, 24);
+  glfwWindowHint(GLFW_STENCIL_BITS, 8);
+  if (gl_debug_output_requested())
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+  if (backend == Backend::headless)
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  if (offscreen_context)
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
 }
 
 void terminate() {
@@ -44,61 +73,251 @@ Renderer::Renderer(std::string window_name, int window_width, int window_height,
       _io_control(control), _camera(camera), _camera_texture(window_width, window_height), _renderables(),
       _near_plane(near_plane), _far_plane(far_plane) {
 
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-  glEnable(GL_CULL_FACE);
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  gl_state().invalidate();
+  gl_state().set_enabled(GL_BLEND, true);
+  gl_state().blend_function(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  gl_state().set_enabled(GL_CULL_FACE, true);
+  gl_state().set_enabled(GL_DEPTH_TEST, true);
+  gl_state().depth_function(GL_LESS);
 
+  if (current_backend() == Backend::headless)
+    _offscreen.emplace(_framebuffer_width, _framebuffer_height);
+  if (const char *csv_path = std::getenv("DARPARU_FRAME_CSV"))
+    _frame_stats.set_csv(csv_path);
   on_framebuffer_shape_change();
 
-  for (auto [renderable, _] : _renderables) {
-    renderable->set_projection(_projection);
-    renderable->set_view(_view);
-  }
-
   _io_control->update();
   _io_control->control(_camera->_position, _camera->_radians, _camera->_zoom);
   update_camera();
   _camera_texture.unbind();
 }
 
-Renderer::~Renderer() { glfwDestroyWindow(_window); }
+Renderer::~Renderer() {
+  // Members holding GL objects are released while the window's context still exists.
+  glfwMakeContextCurrent(_window);
+  _frame_capture.reset();
+  _gpu_profiler.release();
+  _frame_uniforms.reset();
+  _offscreen.reset();
+  glfwDestroyWindow(_window);
+}
+
+// Records the current revision of each renderable, or only the reflected ones, returning whether any changed.
+static bool record_revisions(std::vector<std::pair<const Renderable *, uint64_t>> &revisions,
+                             const std::vector<std::tuple<std::shared_ptr<Renderable>, bool>> &renderables,
+                             bool reflected_only) {
+  bool changed = false;
+  size_t count = 0;
+  for (const auto &[renderable, reflect_draw] : renderables) {
+    if (reflected_only && !reflect_draw)
+      continue;
+    std::pair<const Renderable *, uint64_t> revision{renderable.get(), renderable->revision()};
+    if (count == revisions.size()) {
+      revisions.push_back(revision);
+      changed = true;
+    } else if (revisions[count] != revision) {
+      revisions[count] = revision;
+      changed = true;
+    }
+    ++count;
+  }
+  if (count != revisions.size()) {
+    revisions.resize(count);
+    changed = true;
+  }
+  return changed;
+}
 
-void Renderer::render() {
+bool Renderer::render() {
+  DARPARU_PROFILE_ZONE("Renderer::render");
   glfwMakeContextCurrent(_window);
+  if (_redraw_mode == RedrawMode::on_demand && !redraw_needed()) {
+    // Sleep in the event queue, returning now and then so the caller can advance its simulation.
+    process_events(IDLE_WAIT_SECONDS);
+    if (!redraw_needed())
+      return false;
+  }
+  if (_frame_period.count() > 0) {
+    for (auto now = std::chrono::steady_clock::now(); now < _last_frame_time + _frame_period;
+         now = std::chrono::steady_clock::now())
+      process_events(std::chrono::duration<double>(_last_frame_time + _frame_period - now).count());
+  }
+  _last_frame_time = std::chrono::steady_clock::now();
+  draw_frame();
+  _frame_stats.add(
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _last_frame_time).count());
+  process_events(0.0);
+  return true;
+}
+
+void Renderer::draw_frame() {
+  DARPARU_PROFILE_ZONE("Renderer::draw_frame");
+  _gpu_profiler.begin_frame();
+  GpuProfiler *profiler = _gpu_profiler.enabled() ? &_gpu_profiler : nullptr;
+  const size_t frame_zone = _gpu_profiler.begin("frame");
+  _frame_uniforms->upload();
 
-  _camera_texture.bind();
-  GL_CALL(glClearColor(0.1, 0.1, 0.1, 1.0));
-  GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+  const std::array<int, 4> scissor = refraction_scissor();
+  const bool capture = refraction_outdated(scissor) && scissor[2] > 0 && scissor[3] > 0;
+  _render_queue.clear();
+  _render_queue.set_camera(_view, _projection, _far_plane, _framebuffer_height);
   for (auto [renderable, reflect_draw] : _renderables) {
-    renderable->set_projection(_projection);
-    renderable->set_view(_view);
-    if (reflect_draw)
-      renderable->draw();
+    if (reflect_draw && capture)
+      renderable->submit(_render_queue, RenderPass::refraction);
+    if (!reflect_draw || _pipeline == RenderPipeline::two_pass)
+      renderable->submit(_render_queue, RenderPass::main);
   }
-  _camera_texture.unbind();
+  _render_queue.sort();
+
+  if (capture) {
+    _camera_texture.bind();
+    const bool scissored = scissor[0] > 0 || scissor[1] > 0 || scissor[2] < _camera_texture.texture_width() ||
+                           scissor[3] < _camera_texture.texture_height();
+    gl_state().set_enabled(GL_SCISSOR_TEST, scissored);
+    if (scissored)
+      GL_CALL(glScissor(scissor[0], scissor[1], scissor[2], scissor[3]));
+    GL_CALL(glClearColor(0.1, 0.1, 0.1, 1.0));
+    GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    {
+      GpuProfiler::Scope scope(profiler, "refraction pass");
+      _render_queue.execute(RenderPass::refraction, profiler);
+    }
+    gl_state().set_enabled(GL_SCISSOR_TEST, false);
+    _camera_texture.generate_mipmaps();
+  }
+  _refraction_valid = true;
+
+  if (_pipeline == RenderPipeline::single_pass) {
+    // The window's framebuffer is the same size as the camera texture, so the blit replaces its colour and depth
+    // without needing a clear.
+    _camera_texture.blit_to(output_framebuffer());
+    gl_state().bind_framebuffer(GL_FRAMEBUFFER, output_framebuffer());
+    GL_CALL(glViewport(0, 0, _framebuffer_width, _framebuffer_height));
+  } else {
+    gl_state().bind_framebuffer(GL_FRAMEBUFFER, output_framebuffer());
+    GL_CALL(glViewport(0, 0, _framebuffer_width, _framebuffer_height));
+    GL_CALL(glClearColor(0.1, 0.1, 0.1, 1.0));
+    GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+  }
+  {
+    GpuProfiler::Scope scope(profiler, "main pass");
+    _render_queue.execute(RenderPass::main, profiler);
+  }
+  if (_frame_capture)
+    _frame_capture->capture(output_framebuffer(), _framebuffer_width, _framebuffer_height);
 
-  GL_CALL(glViewport(0, 0, _framebuffer_width, _framebuffer_height));
-  GL_CALL(glClearColor(0.1, 0.1, 0.1, 1.0));
-  GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
-  for (auto [renderable, _] : _renderables) {
-    renderable->set_projection(_projection);
-    renderable->set_view(_view);
-    renderable->draw();
+  _gpu_profiler.end(frame_zone);
+  _gpu_profiler.end_frame();
+  if (_offscreen) {
+    // Nothing is presented, so wait for the frame instead to keep frame times meaningful.
+    GL_CALL(glFinish());
+  } else {
+    GL_CALL(glfwSwapBuffers(_window));
   }
+  _gl_state_counters = gl_state().counters();
+  gl_state().reset_counters();
+}
 
-  GL_CALL(glfwSwapBuffers(_window));
-  if (_io_control->update() && _io_control->control(_camera->_position, _camera->_radians, _camera->_zoom)) {
+GLuint Renderer::output_framebuffer() const { return _offscreen ? _offscreen->framebuffer() : 0; }
+
+void Renderer::process_events(double wait_seconds) {
+  if (_io_control->update(wait_seconds) &&
+      _io_control->control(_camera->_position, _camera->_radians, _camera->_zoom)) {
     update_projection();
     update_camera();
   }
 }
 
+bool Renderer::redraw_needed() {
+  // Everything that changes the camera, projection or lighting also invalidates the refraction capture.
+  bool needed = _redraw_requested.exchange(false) || !_refraction_valid;
+  return record_revisions(_revisions, _renderables, false) || needed;
+}
+
+void Renderer::invalidate() {
+  _redraw_requested = true;
+  glfwPostEmptyEvent();
+}
+
+void Renderer::set_redraw_mode(RedrawMode mode) {
+  _redraw_mode = mode;
+  _redraw_requested = true;
+}
+
+void Renderer::set_frame_rate_limit(double frames_per_second) {
+  if (frames_per_second < 0.0)
+    throw std::invalid_argument("Invalid frame rate limit");
+  _frame_period = frames_per_second > 0.0
+                      ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(1.0 / frames_per_second))
+                      : std::chrono::steady_clock::duration::zero();
+}
+
+bool Renderer::refraction_outdated(const std::array<int, 4> &scissor) {
+  bool outdated = !_refraction_valid || scissor != _refraction_scissor;
+  _refraction_scissor = scissor;
+  return record_revisions(_refraction_revisions, _renderables, true) || outdated;
+}
+
+std::array<int, 4> Renderer::refraction_scissor() const {
+  const int width = _camera_texture.texture_width();
+  const int height = _camera_texture.texture_height();
+  // The single pass pipeline shows the whole capture.
+  if (_pipeline == RenderPipeline::single_pass)
+    return {0, 0, width, height};
+
+  const auto view_projection = multiply_matrices(_projection, _view);
+  // Normalized device coordinates of everything sampling the camera texture.
+  std::array<float, 4> ndc = {1.0f, 1.0f, -1.0f, -1.0f};
+  for (const auto &[renderable, reflect_draw] : _renderables) {
+    auto bounds = renderable->refraction_bounds();
+    if (!bounds)
+      continue;
+    for (int corner = 0; corner < 8; ++corner) {
+      const std::array<float, 4> position = {(corner & 1) ? bounds->max[0] : bounds->min[0],
+                                             (corner & 2) ? bounds->max[1] : bounds->min[1],
+                                             (corner & 4) ? bounds->max[2] : bounds->min[2], 1.0f};
+      const auto clip = multiply_matrix(view_projection, position);
+      // A corner behind the camera projects to nowhere sensible, fall back to the whole texture.
+      if (clip[3] <= 0.0f)
+        return {0, 0, width, height};
+      ndc = {std::min(ndc[0], clip[0] / clip[3]), std::min(ndc[1], clip[1] / clip[3]),
+             std::max(ndc[2], clip[0] / clip[3]), std::max(ndc[3], clip[1] / clip[3])};
+    }
+  }
+  if (ndc[0] > ndc[2] || ndc[1] > ndc[3])
+    return {0, 0, 0, 0};
+
+  // basic_lighting.fs offsets its lookups by up to r = 0.02 in texture coordinates, plus a pixel for filtering.
+  constexpr float margin = 0.02f;
+  const int x0 = std::clamp(static_cast<int>(std::floor((0.5f * ndc[0] + 0.5f - margin) * width)) - 1, 0, width);
+  const int y0 = std::clamp(static_cast<int>(std::floor((0.5f * ndc[1] + 0.5f - margin) * height)) - 1, 0, height);
+  const int x1 = std::clamp(static_cast<int>(std::ceil((0.5f * ndc[2] + 0.5f + margin) * width)) + 1, 0, width);
+  const int y1 = std::clamp(static_cast<int>(std::ceil((0.5f * ndc[3] + 0.5f + margin) * height)) + 1, 0, height);
+  return {x0, y0, x1 - x0, y1 - y0};
+}
+
+void Renderer::set_pipeline(RenderPipeline pipeline) {
+  if (pipeline == RenderPipeline::single_pass && _camera_texture.scale() != 1.0f)
+    throw std::invalid_argument("The single pass pipeline needs a full resolution camera texture");
+  _pipeline = pipeline;
+  _refraction_valid = false;
+}
+
+void Renderer::set_refraction_resolution(float scale, bool mipmaps) {
+  if (_pipeline == RenderPipeline::single_pass && scale != 1.0f)
+    throw std::invalid_argument("The single pass pipeline needs a full resolution camera texture");
+  _camera_texture.set_resolution(scale, mipmaps);
+  _refraction_valid = false;
+}
+
 void Renderer::on_framebuffer_shape_change() {
   glfwGetFramebufferSize(_window, &_framebuffer_width, &_framebuffer_height);
   glfwGetWindowSize(_window, &_window_width, &_window_height);
   _camera_texture.resize(_framebuffer_width, _framebuffer_height);
+  if (_offscreen)
+    _offscreen->resize(_framebuffer_width, _framebuffer_height);
+  _refraction_valid = false;
   update_projection();
 }
 
@@ -108,8 +327,8 @@ void Renderer::update_projection() {
   _projection_context.far_plane = _far_plane;
   _projection_context.zoom = _camera->_zoom;
   _projection = _projection_function(_projection_context);
-  for (auto &[renderable, _] : _renderables)
-    renderable->set_projection(_projection);
+  _frame_uniforms->set_projection(_projection);
+  _refraction_valid = false;
 }
 
 void Renderer::set_projection_function(ProjectionFunction projection_function) {
@@ -117,10 +336,21 @@ void Renderer::set_projection_function(ProjectionFunction projection_function) {
   update_projection();
 }
 
+void Renderer::set_light_position(const std::array<float, 3> &position) {
+  _frame_uniforms->set_light_position(position);
+  _refraction_valid = false;
+}
+
+void Renderer::set_light_color(const std::array<float, 3> &color) {
+  _frame_uniforms->set_light_color(color);
+  _refraction_valid = false;
+}
+
 void Renderer::update_camera() {
   _view = _camera->update();
-  for (auto &[renderable, _] : _renderables)
-    renderable->set_view(_view);
+  _frame_uniforms->set_view(_view);
+  _frame_uniforms->set_view_position(_camera->_position);
+  _refraction_valid = false;
 }
 
 bool Renderer::should_close() { return glfwWindowShouldClose(_window) || _io_control->_escape_pressed; }
@@ -149,14 +379,21 @@ GLFWwindow *Renderer::create_window(std::string window_name, int width, int heig
   // else...
   glfwMakeContextCurrent(window);
   GLenum error = glewInit();
+  // GLEW looks for a GLX display after loading the GL functions, which an EGL context doesn't have.
+  if (error == GLEW_ERROR_NO_GLX_DISPLAY && current_backend() == Backend::headless)
+    error = GLEW_OK;
   if (GLEW_OK != error) {
     glfwDestroyWindow(window);
     throw std::runtime_error(std::string("Error initializing glew: ") +
                              reinterpret_cast<const char *>(glewGetErrorString(error)));
   }
+  if (gl_debug_output_requested() && !enable_gl_debug_output())
+    std::cerr << "OpenGL debug output is not supported by the context" << std::endl;
   glfwSwapInterval(0);
   glfwGetFramebufferSize(window, &_framebuffer_width, &_framebuffer_height);
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+  // Without a compositor an uncovered window's contents are lost, so on demand mode has to redraw it.
+  glfwSetWindowRefreshCallback(window, window_refresh_callback);
   glfwSetWindowUserPointer(window, this);
   glfwSetInputMode(window, GLFW_STICKY_KEYS, GLFW_TRUE);
   glfwSetInputMode(window, GLFW_STICKY_MOUSE_BUTTONS, GLFW_TRUE);
@@ -195,4 +432,9 @@ void Renderer::framebuffer_size_callback(GLFWwindow *window, int width, int heig
   renderer->on_framebuffer_shape_change();
 }
 
+void Renderer::window_refresh_callback(GLFWwindow *window) {
+  Renderer *renderer = static_cast<Renderer *>(glfwGetWindowUserPointer(window));
+  renderer->invalidate();
+}
+
 } // namespace darparu::renderer
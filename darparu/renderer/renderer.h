@@ -1,17 +1,43 @@
 #pragma once
 #include "darparu/renderer/camera.h"
 #include "darparu/renderer/camera_texture.h"
+#include "darparu/renderer/frame_capture.h"
+#include "darparu/renderer/frame_stats.h"
+#include "darparu/renderer/frame_uniforms.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/gpu_profiler.h"
 #include "darparu/renderer/io_control.h"
 #include "darparu/renderer/projection_context.h"
+#include "darparu/renderer/render_queue.h"
 #include "darparu/renderer/renderable.h"
 #include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace darparu::renderer {
 
-void init();
+// two_pass: renderables flagged for reflection are drawn into the camera texture, then everything is drawn again to the
+// window.
+// single_pass: renderables flagged for reflection are drawn once into the camera texture, which is blitted to the
+// window, and only the rest, such as water sampling the camera texture, is drawn on top.
+enum class RenderPipeline { two_pass, single_pass };
+
+// continuous: every call to render draws a frame.
+// on_demand: render only draws when the camera, lighting or a renderable changed, the window needs repainting or
+// invalidate was called, and otherwise waits for input events.
+enum class RedrawMode { continuous, on_demand };
+
+// window: renders to an on screen window.
+// headless: renders into an offscreen framebuffer of an invisible window, or with no display at all of an EGL context,
+// for benchmarks and batch output.
+enum class Backend { window, headless };
+
+void init(Backend backend = Backend::window);
 
 void terminate();
 
@@ -28,6 +54,13 @@ private:
   ProjectionFunction _projection_function;
   ProjectionContext _projection_context;
 
+  // Reset before the window is destroyed, since it owns a uniform buffer.
+  std::optional<FrameUniforms> _frame_uniforms{std::in_place};
+  GlStateCounters _gl_state_counters;
+  RenderQueue _render_queue;
+  GpuProfiler _gpu_profiler;
+  FrameStats _frame_stats;
+
 public:
   Renderer(std::string window_name, int window_width, int window_height, ProjectionFunction projection_function,
            std::shared_ptr<IoControl> control, std::shared_ptr<Camera> camera, float near_plane, float far_plane);
@@ -40,15 +73,72 @@ public:
   CameraTexture _camera_texture;
   std::vector<std::tuple<std::shared_ptr<Renderable>, bool>> _renderables;
   void update_camera();
-  void render();
+  // Returns whether a frame was drawn, which in on demand mode is only when something changed.
+  bool render();
+  // Requests a redraw in on demand mode, safe to call from any thread.
+  void invalidate();
   bool should_close();
   std::array<float, 3> get_cursor_direction();
 
   void set_projection_function(ProjectionFunction projection_function);
+  void set_light_position(const std::array<float, 3> &position);
+  void set_light_color(const std::array<float, 3> &color);
+  void set_pipeline(RenderPipeline pipeline);
+  // Renders the camera texture at a fraction of the framebuffer's resolution, optionally mipmapped. The single pass
+  // pipeline needs the full resolution.
+  void set_refraction_resolution(float scale, bool mipmaps);
+  void set_redraw_mode(RedrawMode mode);
+  // Caps how often frames are drawn, 0 for no limit. Input is still handled while waiting.
+  void set_frame_rate_limit(double frames_per_second);
+  // Captures every drawn frame, until replaced or reset with nullptr.
+  void set_frame_capture(std::shared_ptr<FrameCapture> capture) { _frame_capture = std::move(capture); }
+
+  // The headless backend's render target, which holds the last frame.
+  const std::optional<CameraTexture> &offscreen() const { return _offscreen; }
+
+  // Times of drawn frames, from the start of drawing until presented, or finished when headless. Nothing is reported
+  // unless set_report is called, but every frame time is appended to the CSV file named by the DARPARU_FRAME_CSV
+  // environment variable if it is set.
+  FrameStats &frame_stats() { return _frame_stats; }
+  const FrameStats &frame_stats() const { return _frame_stats; }
+
+  // GPU times of the frame, its passes and each renderable's draws, a few frames behind. Off until enabled.
+  GpuProfiler &gpu_profiler() { return _gpu_profiler; }
+  const GpuProfiler &gpu_profiler() const { return _gpu_profiler; }
+
+  std::array<int, 2> framebuffer_size() const { return {_framebuffer_width, _framebuffer_height}; }
+
+  // State changes, draw calls and triangles of the last rendered frame.
+  const GlStateCounters &gl_state_counters() const { return _gl_state_counters; }
 
 private:
   float _near_plane;
   float _far_plane;
+  RenderPipeline _pipeline = RenderPipeline::two_pass;
+  std::optional<CameraTexture> _offscreen;
+  std::shared_ptr<FrameCapture> _frame_capture;
+
+  // The camera texture is only re-rendered when the camera, lighting or a reflected renderable has changed since.
+  bool _refraction_valid = false;
+  std::vector<std::pair<const Renderable *, uint64_t>> _refraction_revisions;
+  // x, y, width and height in camera texture pixels.
+  std::array<int, 4> _refraction_scissor{};
+
+  // How long an idle on demand render waits for events before returning to the caller.
+  static constexpr double IDLE_WAIT_SECONDS = 0.1;
+
+  RedrawMode _redraw_mode = RedrawMode::continuous;
+  std::atomic<bool> _redraw_requested = true;
+  std::vector<std::pair<const Renderable *, uint64_t>> _revisions;
+  std::chrono::steady_clock::duration _frame_period = std::chrono::steady_clock::duration::zero();
+  std::chrono::steady_clock::time_point _last_frame_time;
+
+  void draw_frame();
+  GLuint output_framebuffer() const;
+  void process_events(double wait_seconds);
+  bool redraw_needed();
+  bool refraction_outdated(const std::array<int, 4> &scissor);
+  std::array<int, 4> refraction_scissor() const;
 
   void on_framebuffer_shape_change();
   void update_projection();
@@ -60,6 +150,7 @@ private:
   static void cursor_position_callback(GLFWwindow *window, double xpos, double ypos);
   static void scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
   static void framebuffer_size_callback(GLFWwindow *window, int width, int height);
+  static void window_refresh_callback(GLFWwindow *window);
 };
 
 } // namespace darparu::renderer
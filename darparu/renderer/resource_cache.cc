@@ -0,0 +1,61 @@
+#include "darparu/renderer/resource_cache.h"
+#include <string_view>
+
+namespace darparu::renderer {
+
+static std::uint64_t source_hash(const std::string &vertex_source, const std::string &fragment_source) {
+  const std::uint64_t vertex_hash = std::hash<std::string_view>{}(vertex_source);
+  const std::uint64_t fragment_hash = std::hash<std::string_view>{}(fragment_source);
+  return vertex_hash ^ (fragment_hash + 0x9e3779b97f4a7c15ull + (vertex_hash << 6) + (vertex_hash >> 2));
+}
+
+const std::string &ResourceCache::file(const std::string &path) {
+  auto it = _files.find(path);
+  if (it == _files.end())
+    it = _files.emplace(path, read_file(path)).first;
+  return it->second;
+}
+
+std::shared_ptr<Shader> ResourceCache::shader(const std::string &vertex_path, const std::string &fragment_path) {
+  return shader_from_source(file(vertex_path), file(fragment_path));
+}
+
+std::shared_ptr<Shader> ResourceCache::shader_from_source(const std::string &vertex_source,
+                                                          const std::string &fragment_source) {
+  const std::uint64_t hash = source_hash(vertex_source, fragment_source);
+  auto it = _shaders.find(hash);
+  if (it != _shaders.end()) {
+    auto shader = it->second.shader.lock();
+    if (shader && it->second.vertex_source == vertex_source && it->second.fragment_source == fragment_source)
+      return shader;
+    if (shader)
+      // A hash collision with a live program, which keeps its entry while this one goes unshared.
+      return std::make_shared<Shader>(vertex_source, fragment_source);
+  }
+  auto shader = std::make_shared<Shader>(vertex_source, fragment_source);
+  _shaders[hash] = {vertex_source, fragment_source, shader};
+  return shader;
+}
+
+std::shared_ptr<StaticMesh> ResourceCache::mesh(const std::string &key,
+                                                const std::function<std::shared_ptr<StaticMesh>()> &create) {
+  auto &cached = _meshes[key];
+  if (auto mesh = cached.lock())
+    return mesh;
+  auto mesh = create();
+  cached = mesh;
+  return mesh;
+}
+
+void ResourceCache::clear() {
+  _files.clear();
+  std::erase_if(_shaders, [](const auto &entry) { return entry.second.shader.expired(); });
+  std::erase_if(_meshes, [](const auto &entry) { return entry.second.expired(); });
+}
+
+ResourceCache &resource_cache() {
+  static ResourceCache cache;
+  return cache;
+}
+
+} // namespace darparu::renderer
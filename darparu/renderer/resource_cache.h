@@ -0,0 +1,44 @@
+#pragma once
+#include "darparu/renderer/shader.h"
+#include "darparu/renderer/static_mesh.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace darparu::renderer {
+
+// Shares GPU resources between entities. Programs are interned by the hash of their sources and static meshes by a
+// caller chosen key. The cache only holds weak references, so a resource is released with its last user and rebuilt
+// on the next request.
+class ResourceCache {
+public:
+  // File contents are kept for the lifetime of the cache.
+  const std::string &file(const std::string &path);
+
+  std::shared_ptr<Shader> shader(const std::string &vertex_path, const std::string &fragment_path);
+  std::shared_ptr<Shader> shader_from_source(const std::string &vertex_source, const std::string &fragment_source);
+
+  // Calls create only when no live mesh exists for the key.
+  std::shared_ptr<StaticMesh> mesh(const std::string &key, const std::function<std::shared_ptr<StaticMesh>()> &create);
+
+  // Forgets cached files and expired entries.
+  void clear();
+
+private:
+  struct ShaderEntry {
+    std::string vertex_source;
+    std::string fragment_source;
+    std::weak_ptr<Shader> shader;
+  };
+
+  std::unordered_map<std::string, std::string> _files;
+  std::unordered_map<std::uint64_t, ShaderEntry> _shaders;
+  std::unordered_map<std::string, std::weak_ptr<StaticMesh>> _meshes;
+};
+
+// The resource cache of the renderer's (single) GL context.
+ResourceCache &resource_cache();
+
+} // namespace darparu::renderer
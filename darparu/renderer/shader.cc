@@ -1,5 +1,9 @@
 #include "darparu/renderer/shader.h"
+#include "darparu/profile.h"
+#include "darparu/renderer/frame_uniforms.h"
 #include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
@@ -8,9 +12,11 @@
 namespace darparu::renderer {
 
 Shader::Shader(std::string vertex_source_code, std::string fragment_source_code)
-    : _program(load_program(vertex_source_code, fragment_source_code)) {}
+    : _program(load_program(vertex_source_code, fragment_source_code)),
+      _uniform_locations(reflect_uniforms(_program)) {}
 
 GLuint Shader::load_program(std::string vertex_source_code, std::string fragment_source_code) {
+  DARPARU_PROFILE_ZONE("Shader::load_program");
   GLuint vertex_shader = load_vertex_shader(vertex_source_code);
   GLuint fragment_shader = load_fragment_shader(fragment_source_code);
   GLuint shader_program = glCreateProgram();
@@ -27,36 +33,77 @@ GLuint Shader::load_program(std::string vertex_source_code, std::string fragment
     throw std::runtime_error(std::string("ERROR::SHADER::PROGRAM::FAILED\n") + info_log);
   }
   // else...
+  GLuint frame_block_index = glGetUniformBlockIndex(shader_program, FRAME_UNIFORMS_BLOCK_NAME);
+  if (frame_block_index != GL_INVALID_INDEX)
+    GL_CALL(glUniformBlockBinding(shader_program, frame_block_index, FRAME_UNIFORMS_BINDING));
   return shader_program;
 };
 
 Shader::~Shader() {
   if (_program != 0)
-    glDeleteProgram(_program);
+    gl_state().delete_program(_program);
 }
 
-void Shader::use() { GL_CALL(glUseProgram(_program)); }
+void Shader::use() { gl_state().use_program(_program); }
 
-void Shader::unuse() { GL_CALL(glUseProgram(0)); }
+void Shader::unuse() { gl_state().use_program(0); }
 
-void Shader::set_uniform(const std::string &name, int value) {
-  GLuint location = glGetUniformLocation(_program, name.c_str());
-  GL_CALL(glUniform1i(location, value););
+GLint Shader::location(std::string_view name) const {
+  auto it = _uniform_locations.find(name);
+  return it == _uniform_locations.end() ? -1 : it->second;
 }
 
+void Shader::set(Uniform<int> uniform, int value) { GL_CALL(glProgramUniform1i(_program, uniform.location, value)); }
+
+void Shader::set(Uniform<std::array<float, 2>> uniform, const std::array<float, 2> &vector) {
+  GL_CALL(glProgramUniform2fv(_program, uniform.location, 1, vector.data()));
+}
+
+void Shader::set(Uniform<std::array<float, 3>> uniform, const std::array<float, 3> &vector) {
+  GL_CALL(glProgramUniform3fv(_program, uniform.location, 1, vector.data()));
+}
+
+void Shader::set(Uniform<std::array<float, 16>> uniform, const std::array<float, 16> &matrix) {
+  GL_CALL(glProgramUniformMatrix4fv(_program, uniform.location, 1, GL_TRUE, matrix.data()));
+}
+
+void Shader::set_uniform(const std::string &name, int value) { set(uniform<int>(name), value); }
+
 void Shader::set_uniform_vector(const std::string &name, const std::array<float, 2> &vector) {
-  GLuint location = glGetUniformLocation(_program, name.c_str());
-  GL_CALL(glUniform2fv(location, 1, vector.data()););
+  set(uniform<std::array<float, 2>>(name), vector);
 }
 
 void Shader::set_uniform_vector(const std::string &name, const std::array<float, 3> &vector) {
-  GLuint location = glGetUniformLocation(_program, name.c_str());
-  GL_CALL(glUniform3fv(location, 1, vector.data()););
+  set(uniform<std::array<float, 3>>(name), vector);
 }
 
 void Shader::set_uniform_matrix(const std::string &name, const std::array<float, 16> &matrix) {
-  GLuint location = glGetUniformLocation(_program, name.c_str());
-  GL_CALL(glUniformMatrix4fv(location, 1, GL_TRUE, matrix.data()););
+  set(uniform<std::array<float, 16>>(name), matrix);
+}
+
+UniformLocations Shader::reflect_uniforms(GLuint program) {
+  UniformLocations locations;
+  GLint count = 0;
+  GLint max_length = 0;
+  GL_CALL(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+  GL_CALL(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+  std::string name(std::max(max_length, 1), '\0');
+  for (GLint index = 0; index < count; ++index) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(program, index, max_length, &length, &size, &type, name.data());
+    std::string_view active_name(name.data(), length);
+    // Members of uniform blocks have no location.
+    GLint location = glGetUniformLocation(program, std::string(active_name).c_str());
+    if (location == -1)
+      continue;
+    locations.emplace(active_name, location);
+    // Arrays are reported as "name[0]", make them addressable by their plain name too.
+    if (active_name.ends_with("[0]"))
+      locations.emplace(active_name.substr(0, active_name.size() - 3), location);
+  }
+  return locations;
 }
 
 GLuint Shader::load_vertex_shader(std::string vertex_source_code) {
@@ -92,6 +139,7 @@ GLuint Shader::load_fragment_shader(std::string fragment_source) {
 };
 
 std::string read_file(const std::string &file_path) {
+  DARPARU_PROFILE_ZONE("read_file");
   std::ifstream file(file_path);
   if (!file) {
     throw std::runtime_error("Could not open file: " + file_path);
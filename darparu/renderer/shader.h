@@ -1,13 +1,29 @@
 #pragma once
 #include <GL/glew.h>
 #include <array>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace darparu::renderer {
 
+// A uniform location resolved once, typed by the value it accepts.
+template <typename T> struct Uniform {
+  GLint location = -1;
+};
+
+struct UniformNameHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+};
+
+using UniformLocations = std::unordered_map<std::string, GLint, UniformNameHash, std::equal_to<>>;
+
 class Shader {
 private:
   GLuint _program;
+  UniformLocations _uniform_locations;
 
 public:
   Shader(std::string vertex_source_code, std::string fragment_source_code);
@@ -21,6 +37,17 @@ public:
 
   void use();
   void unuse();
+  GLuint id() const { return _program; }
+
+  // Returns -1 for names that are not active uniforms of the program, which GL ignores when set.
+  GLint location(std::string_view name) const;
+  template <typename T> Uniform<T> uniform(std::string_view name) const { return {location(name)}; }
+
+  void set(Uniform<int> uniform, int value);
+  void set(Uniform<std::array<float, 2>> uniform, const std::array<float, 2> &vector);
+  void set(Uniform<std::array<float, 3>> uniform, const std::array<float, 3> &vector);
+  void set(Uniform<std::array<float, 16>> uniform, const std::array<float, 16> &matrix);
+
   void set_uniform(const std::string &name, int value);
   void set_uniform_vector(const std::string &name, const std::array<float, 2> &vector);
   void set_uniform_vector(const std::string &name, const std::array<float, 3> &vector);
@@ -30,6 +57,7 @@ private:
   GLuint load_program(std::string vertex_source_code, std::string fragment_source_code);
   GLuint load_vertex_shader(std::string vertex_source_code);
   GLuint load_fragment_shader(std::string fragment_source);
+  static UniformLocations reflect_uniforms(GLuint program);
 };
 
 std::string read_file(const std::string &file_path);
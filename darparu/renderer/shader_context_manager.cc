@@ -4,6 +4,4 @@ namespace darparu::renderer {
 
 ShaderContextManager::ShaderContextManager(Shader &shader) : _shader(shader) { _shader.use(); }
 
-ShaderContextManager::~ShaderContextManager() { _shader.unuse(); }
-
 } // namespace darparu::renderer
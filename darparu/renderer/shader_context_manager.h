@@ -3,10 +3,11 @@
 
 namespace darparu::renderer {
 
+// Makes the shader current for a draw. The program is left bound afterwards, since the next draw will usually bind its
+// own program and unbinding in between would double the program changes.
 class ShaderContextManager {
 public:
   ShaderContextManager(Shader &shader);
-  ~ShaderContextManager();
 
 private:
   Shader &_shader;
@@ -0,0 +1,54 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+flat in vec3 Center;
+flat in float Radius;
+flat in vec3 Color;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+void main() {
+    // Ray-cast the sphere through this fragment of its quad.
+    vec3 cameraBack = vec3(view[0][2], view[1][2], view[2][2]);
+    vec3 cameraPosition = -transpose(mat3(view)) * vec3(view[3]);
+    bool orthographic = projection[3][3] == 1.0;
+    vec3 direction = orthographic ? -cameraBack : normalize(FragPos - cameraPosition);
+    vec3 origin = orthographic ? FragPos + 2.0 * Radius * cameraBack : cameraPosition;
+
+    vec3 oc = origin - Center;
+    float b = dot(oc, direction);
+    float h = b * b - (dot(oc, oc) - Radius * Radius);
+    if (h < 0.0)
+        discard;
+    vec3 hit = origin + (-b - sqrt(h)) * direction;
+
+    vec4 clip = projection * view * vec4(hit, 1.0);
+    gl_FragDepth = 0.5 * clip.z / clip.w + 0.5;
+
+    // ambient
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // diffuse
+    vec3 norm = (hit - Center) / Radius;
+    vec3 lightDir = normalize(lightPos - hit);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // specular
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - hit);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 256);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    vec4 result = vec4(ambient + diffuse + specular, 1.0) * vec4(Color, 1.0);
+    FragColor = result;
+}
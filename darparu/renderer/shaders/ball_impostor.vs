@@ -0,0 +1,49 @@
+#version 330 core
+layout(location = 0) in vec4 aCenterRadius;
+layout(location = 1) in vec3 aColor;
+
+uniform mat4 model;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+out vec3 FragPos;
+flat out vec3 Center;
+flat out float Radius;
+flat out vec3 Color;
+
+const vec2 corners[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main() {
+	Center = vec3(model * vec4(aCenterRadius.xyz, 1.0));
+	Radius = aCenterRadius.w * length(vec3(model[0]));
+	Color = aColor;
+
+	// The rows of the view rotation are the camera axes in world space.
+	vec3 cameraRight = vec3(view[0][0], view[1][0], view[2][0]);
+	vec3 cameraUp = vec3(view[0][1], view[1][1], view[2][1]);
+	vec3 cameraPosition = -transpose(mat3(view)) * vec3(view[3]);
+
+	vec3 right = cameraRight;
+	vec3 up = cameraUp;
+	float halfSize = Radius;
+	if (projection[3][3] != 1.0) {
+		// Face the camera and grow the quad to the silhouette, the cone of tangents from the camera meets the plane
+		// through the centre at r * d / sqrt(d^2 - r^2).
+		vec3 toCamera = cameraPosition - Center;
+		float distance = length(toCamera);
+		vec3 forward = toCamera / distance;
+		right = normalize(cross(cameraUp, forward));
+		up = cross(forward, right);
+		halfSize = Radius * distance / sqrt(max(distance * distance - Radius * Radius, 1e-6));
+	}
+
+	vec2 corner = corners[gl_VertexID];
+	FragPos = Center + (corner.x * right + corner.y * up) * halfSize;
+	gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -3,11 +3,16 @@ out vec4 FragColor;
 
 in vec3 Normal;
 in vec3 FragPos;
-in vec2 ScreenPos;
+noperspective in vec2 ScreenPos;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
 uniform sampler2D background;
 
 void main() {
@@ -5,16 +5,22 @@ layout(location = 2) in float aTranslateY;
 
 out vec3 FragPos;
 out vec3 Normal;
-out vec2 ScreenPos;
+noperspective out vec2 ScreenPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 void main() {
     FragPos = vec3(model * vec4(vec3(aPosXZ.x, aTranslateY, aPosXZ.y), 1.0));
     Normal = aNormal;
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
-    ScreenPos = vec2(0.5, 0.5) + 0.5 * vec2(gl_Position) / gl_Position.z;
+    ScreenPos = vec2(0.5, 0.5) + 0.5 * vec2(gl_Position) / gl_Position.w;
 }
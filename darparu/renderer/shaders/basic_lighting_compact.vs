@@ -0,0 +1,35 @@
+#version 330 core
+layout(location = 0) in vec2 aPosXZ;
+layout(location = 1) in vec2 aOctahedralNormal;
+layout(location = 2) in float aTranslateY;
+
+out vec3 FragPos;
+out vec3 Normal;
+noperspective out vec2 ScreenPos;
+
+uniform mat4 model;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+// Inverse of the octahedral encoding in water_packing.cc, y is the octahedron's pole.
+vec3 decode_octahedral(vec2 e) {
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    float t = max(-n.y, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.z += n.z >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    FragPos = vec3(model * vec4(vec3(aPosXZ.x, aTranslateY, aPosXZ.y), 1.0));
+    Normal = decode_octahedral(aOctahedralNormal);
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+    ScreenPos = vec2(0.5, 0.5) + 0.5 * vec2(gl_Position) / gl_Position.w;
+}
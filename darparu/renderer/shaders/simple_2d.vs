@@ -3,8 +3,14 @@ layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec3 aColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
 
 out vec3 Color;
 
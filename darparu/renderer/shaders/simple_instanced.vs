@@ -0,0 +1,26 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec4 aCenterRadius;
+layout(location = 3) in vec3 aColor;
+
+uniform mat4 model;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 Color;
+
+void main() {
+	FragPos = vec3(model * vec4(aPos * aCenterRadius.w + aCenterRadius.xyz, 1.0));
+	Normal = aNormal;
+	Color = aColor;
+	gl_Position = projection * view * vec4(FragPos, 1.0);
+}
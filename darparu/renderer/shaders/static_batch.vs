@@ -0,0 +1,28 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec3 aColor;
+layout(location = 3) in float aEmissive;
+
+uniform mat4 model;
+
+layout(std140, row_major) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightColor;
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 Color;
+out float Emissive;
+
+void main() {
+	FragPos = vec3(model * vec4(aPos, 1.0));
+	Normal = mat3(model) * aNormal;
+	Color = aColor;
+	Emissive = aEmissive;
+	gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Uv;
+in vec3 Color;
+
+// Coverage in the red channel.
+uniform sampler2D atlas;
+
+void main() {
+    FragColor = vec4(Color, texture(atlas, Uv).r);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+// x, y, width and height in pixels from the top left of the screen.
+layout(location = 0) in vec4 aRect;
+// u0, v0, u1, v1 in the glyph atlas.
+layout(location = 1) in vec4 aUv;
+layout(location = 2) in vec3 aColor;
+
+uniform vec2 screen_size;
+
+out vec2 Uv;
+out vec3 Color;
+
+// Counter clockwise on screen, where y points down: bottom left, bottom right, top left, top right.
+const vec2 corners[4] = vec2[4](vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0));
+
+void main() {
+	vec2 corner = corners[gl_VertexID];
+	vec2 pixel = aRect.xy + corner * aRect.zw;
+	Uv = mix(aUv.xy, aUv.zw, corner);
+	Color = aColor;
+	gl_Position = vec4(pixel.x / screen_size.x * 2.0 - 1.0, 1.0 - pixel.y / screen_size.y * 2.0, 0.0, 1.0);
+}
@@ -0,0 +1,77 @@
+#include "darparu/renderer/simd_algebra.h"
+#include <cmath>
+
+namespace darparu::renderer {
+
+void transform(const Mat4 &matrix, std::span<const std::array<float, 4>> vectors,
+               std::span<std::array<float, 4>> output) {
+  const Mat4 transposed = transpose(matrix);
+  for (size_t i = 0; i < vectors.size(); ++i)
+    transform_transposed(transposed, Vec4::load(vectors[i])).store(output[i].data());
+}
+
+// 2x2 matrices [a b; c d] held as the lanes a, b, c, d.
+static Vec4 mat2_multiply(const Vec4 &a, const Vec4 &b) {
+  return a * shuffle<0, 3, 0, 3>(b, b) + shuffle<1, 0, 3, 2>(a, a) * shuffle<2, 1, 2, 1>(b, b);
+}
+
+// adjugate(a) * b
+static Vec4 mat2_adjugate_multiply(const Vec4 &a, const Vec4 &b) {
+  return shuffle<3, 3, 0, 0>(a, a) * b - shuffle<1, 1, 2, 2>(a, a) * shuffle<2, 3, 0, 1>(b, b);
+}
+
+// a * adjugate(b)
+static Vec4 mat2_multiply_adjugate(const Vec4 &a, const Vec4 &b) {
+  return a * shuffle<3, 0, 3, 0>(b, b) - shuffle<1, 0, 3, 2>(a, a) * shuffle<2, 1, 2, 1>(b, b);
+}
+
+Mat4 inverse(const Mat4 &matrix) {
+  const auto &[r0, r1, r2, r3] = matrix.rows;
+  // The matrix as 2x2 blocks [A B; C D].
+  const Vec4 a = shuffle<0, 1, 0, 1>(r0, r1);
+  const Vec4 b = shuffle<2, 3, 2, 3>(r0, r1);
+  const Vec4 c = shuffle<0, 1, 0, 1>(r2, r3);
+  const Vec4 d = shuffle<2, 3, 2, 3>(r2, r3);
+
+  // |A|, |B|, |C| and |D|.
+  const Vec4 block_determinants = shuffle<0, 2, 0, 2>(r0, r2) * shuffle<1, 3, 1, 3>(r1, r3) -
+                                  shuffle<1, 3, 1, 3>(r0, r2) * shuffle<0, 2, 0, 2>(r1, r3);
+  const Vec4 det_a = block_determinants.broadcast<0>();
+  const Vec4 det_b = block_determinants.broadcast<1>();
+  const Vec4 det_c = block_determinants.broadcast<2>();
+  const Vec4 det_d = block_determinants.broadcast<3>();
+
+  const Vec4 d_c = mat2_adjugate_multiply(d, c);
+  const Vec4 a_b = mat2_adjugate_multiply(a, b);
+  const Vec4 x = det_d * a - mat2_multiply(b, d_c);
+  const Vec4 w = det_a * d - mat2_multiply(c, a_b);
+  const Vec4 y = det_b * c - mat2_multiply_adjugate(d, a_b);
+  const Vec4 z = det_c * b - mat2_multiply_adjugate(a, d_c);
+
+  // |M| = |A||D| + |B||C| - tr((A#B)(D#C)), # being the adjugate product.
+  Vec4 trace = a_b * shuffle<0, 2, 1, 3>(d_c, d_c);
+  trace = trace + shuffle<1, 0, 3, 2>(trace, trace);
+  trace = trace + shuffle<2, 3, 0, 1>(trace, trace);
+  const Vec4 determinant = det_a * det_d + det_b * det_c - trace;
+
+  // |M| relative to Hadamard's bound, the product of the row lengths, measures how close the rows are to linearly
+  // dependent independently of the matrix's scale. Near singular matrices would give huge or infinite entries, which
+  // -ffast-math does not guard against, so they give the identity like singular ones.
+  const Mat4 squares = transpose({{r0 * r0, r1 * r1, r2 * r2, r3 * r3}});
+  const auto lengths_squared = (squares.rows[0] + squares.rows[1] + squares.rows[2] + squares.rows[3]).array();
+  const float bound =
+      std::sqrt(lengths_squared[0] * lengths_squared[1]) * std::sqrt(lengths_squared[2] * lengths_squared[3]);
+  if (!(std::abs(determinant.array()[0]) > SINGULAR_THRESHOLD * bound))
+    return {{Vec4::load({1.0f, 0.0f, 0.0f, 0.0f}), Vec4::load({0.0f, 1.0f, 0.0f, 0.0f}),
+             Vec4::load({0.0f, 0.0f, 1.0f, 0.0f}), Vec4::load({0.0f, 0.0f, 0.0f, 1.0f})}};
+
+  const Vec4 scale = Vec4::load({1.0f, -1.0f, -1.0f, 1.0f}) / determinant;
+  const Vec4 x_scaled = x * scale;
+  const Vec4 y_scaled = y * scale;
+  const Vec4 z_scaled = z * scale;
+  const Vec4 w_scaled = w * scale;
+  return {{shuffle<3, 1, 3, 1>(x_scaled, y_scaled), shuffle<2, 0, 2, 0>(x_scaled, y_scaled),
+           shuffle<3, 1, 3, 1>(z_scaled, w_scaled), shuffle<2, 0, 2, 0>(z_scaled, w_scaled)}};
+}
+
+} // namespace darparu::renderer
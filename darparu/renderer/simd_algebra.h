@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+
+// SSE is part of every x86-64 target and NEON of every AArch64 one, so neither needs runtime dispatch, and AVX is used
+// when the compiler targets it, e.g. with -march=native in opt builds. Define DARPARU_NO_SIMD to use the plain float
+// fallback, e.g. to compare against it.
+#if !defined(DARPARU_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define DARPARU_SIMD_SSE
+#include <immintrin.h>
+#elif !defined(DARPARU_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__) &&                                     \
+    (defined(__clang__) || defined(__GNUC__))
+#define DARPARU_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace darparu::renderer {
+
+// Four floats in one SIMD register.
+struct alignas(16) Vec4 {
+#if defined(DARPARU_SIMD_SSE)
+  __m128 v;
+#elif defined(DARPARU_SIMD_NEON)
+  float32x4_t v;
+#else
+  std::array<float, 4> v;
+#endif
+
+  static Vec4 load(const float *values) {
+#if defined(DARPARU_SIMD_SSE)
+    return {_mm_loadu_ps(values)};
+#elif defined(DARPARU_SIMD_NEON)
+    return {vld1q_f32(values)};
+#else
+    return {{values[0], values[1], values[2], values[3]}};
+#endif
+  }
+  static Vec4 load(const std::array<float, 4> &values) { return load(values.data()); }
+
+  static Vec4 splat(float value) {
+#if defined(DARPARU_SIMD_SSE)
+    return {_mm_set1_ps(value)};
+#elif defined(DARPARU_SIMD_NEON)
+    return {vdupq_n_f32(value)};
+#else
+    return {{value, value, value, value}};
+#endif
+  }
+
+  void store(float *values) const {
+#if defined(DARPARU_SIMD_SSE)
+    _mm_storeu_ps(values, v);
+#elif defined(DARPARU_SIMD_NEON)
+    vst1q_f32(values, v);
+#else
+    std::copy(v.begin(), v.end(), values);
+#endif
+  }
+  std::array<float, 4> array() const {
+    std::array<float, 4> values;
+    store(values.data());
+    return values;
+  }
+
+  // Every lane set to lane I.
+  template <int I> Vec4 broadcast() const {
+#if defined(DARPARU_SIMD_SSE)
+    return {_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I))};
+#elif defined(DARPARU_SIMD_NEON)
+    return {vdupq_laneq_f32(v, I)};
+#else
+    return splat(v[I]);
+#endif
+  }
+};
+
+// Lanes X and Y of a followed by lanes Z and W of b, like _mm_shuffle_ps.
+template <int X, int Y, int Z, int W> inline Vec4 shuffle(const Vec4 &a, const Vec4 &b) {
+#if defined(DARPARU_SIMD_SSE)
+  return {_mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(W, Z, Y, X))};
+#elif defined(DARPARU_SIMD_NEON)
+  return {__builtin_shufflevector(a.v, b.v, X, Y, Z + 4, W + 4)};
+#else
+  return {{a.v[X], a.v[Y], b.v[Z], b.v[W]}};
+#endif
+}
+
+inline Vec4 operator+(const Vec4 &a, const Vec4 &b) {
+#if defined(DARPARU_SIMD_SSE)
+  return {_mm_add_ps(a.v, b.v)};
+#elif defined(DARPARU_SIMD_NEON)
+  return {vaddq_f32(a.v, b.v)};
+#else
+  return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+}
+
+inline Vec4 operator-(const Vec4 &a, const Vec4 &b) {
+#if defined(DARPARU_SIMD_SSE)
+  return {_mm_sub_ps(a.v, b.v)};
+#elif defined(DARPARU_SIMD_NEON)
+  return {vsubq_f32(a.v, b.v)};
+#else
+  return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+#endif
+}
+
+inline Vec4 operator*(const Vec4 &a, const Vec4 &b) {
+#if defined(DARPARU_SIMD_SSE)
+  return {_mm_mul_ps(a.v, b.v)};
+#elif defined(DARPARU_SIMD_NEON)
+  return {vmulq_f32(a.v, b.v)};
+#else
+  return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+}
+
+inline Vec4 operator/(const Vec4 &a, const Vec4 &b) {
+#if defined(DARPARU_SIMD_SSE)
+  return {_mm_div_ps(a.v, b.v)};
+#elif defined(DARPARU_SIMD_NEON)
+  return {vdivq_f32(a.v, b.v)};
+#else
+  return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}};
+#endif
+}
+
+// A row major 4x4 matrix, laid out like the std::array<float, 16> matrices of algebra.h.
+struct alignas(16) Mat4 {
+  std::array<Vec4, 4> rows;
+
+  static Mat4 load(const std::array<float, 16> &values) {
+    return {{Vec4::load(values.data()), Vec4::load(values.data() + 4), Vec4::load(values.data() + 8),
+             Vec4::load(values.data() + 12)}};
+  }
+  // Unrolled, GCC turns the loop into a memcpy of the rows spilled to the stack.
+  void store(float *values) const {
+    rows[0].store(values);
+    rows[1].store(values + 4);
+    rows[2].store(values + 8);
+    rows[3].store(values + 12);
+  }
+  std::array<float, 16> array() const {
+    std::array<float, 16> values;
+    store(values.data());
+    return values;
+  }
+};
+
+inline Mat4 transpose(const Mat4 &matrix) {
+  const auto &[r0, r1, r2, r3] = matrix.rows;
+  const Vec4 t0 = shuffle<0, 1, 0, 1>(r0, r1);
+  const Vec4 t1 = shuffle<2, 3, 2, 3>(r0, r1);
+  const Vec4 t2 = shuffle<0, 1, 0, 1>(r2, r3);
+  const Vec4 t3 = shuffle<2, 3, 2, 3>(r2, r3);
+  return {{shuffle<0, 2, 0, 2>(t0, t2), shuffle<1, 3, 1, 3>(t0, t2), shuffle<0, 2, 0, 2>(t1, t3),
+           shuffle<1, 3, 1, 3>(t1, t3)}};
+}
+
+// Each row of the product is a combination of b's rows weighted by a row of a. With AVX two rows are combined at once.
+inline Mat4 operator*(const Mat4 &a, const Mat4 &b) {
+#if defined(DARPARU_SIMD_SSE) && defined(__AVX__)
+  const __m256 b0 = _mm256_set_m128(b.rows[0].v, b.rows[0].v);
+  const __m256 b1 = _mm256_set_m128(b.rows[1].v, b.rows[1].v);
+  const __m256 b2 = _mm256_set_m128(b.rows[2].v, b.rows[2].v);
+  const __m256 b3 = _mm256_set_m128(b.rows[3].v, b.rows[3].v);
+  const auto rows = [&](const Vec4 &first, const Vec4 &second) {
+    const __m256 weights = _mm256_set_m128(second.v, first.v);
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(weights, weights, 0x00), b0),
+                                       _mm256_mul_ps(_mm256_shuffle_ps(weights, weights, 0x55), b1)),
+                         _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(weights, weights, 0xaa), b2),
+                                       _mm256_mul_ps(_mm256_shuffle_ps(weights, weights, 0xff), b3)));
+  };
+  const __m256 rows01 = rows(a.rows[0], a.rows[1]);
+  const __m256 rows23 = rows(a.rows[2], a.rows[3]);
+  return {{Vec4{_mm256_castps256_ps128(rows01)}, Vec4{_mm256_extractf128_ps(rows01, 1)},
+           Vec4{_mm256_castps256_ps128(rows23)}, Vec4{_mm256_extractf128_ps(rows23, 1)}}};
+#else
+  const auto row = [&b](const Vec4 &weights) {
+    return weights.broadcast<0>() * b.rows[0] + weights.broadcast<1>() * b.rows[1] +
+           weights.broadcast<2>() * b.rows[2] + weights.broadcast<3>() * b.rows[3];
+  };
+  return {{row(a.rows[0]), row(a.rows[1]), row(a.rows[2]), row(a.rows[3])}};
+#endif
+}
+
+// The matrix times a column vector, given the transposed matrix so that loops over many vectors transpose once.
+inline Vec4 transform_transposed(const Mat4 &transposed, const Vec4 &vector) {
+  return transposed.rows[0] * vector.broadcast<0>() + transposed.rows[1] * vector.broadcast<1>() +
+         transposed.rows[2] * vector.broadcast<2>() + transposed.rows[3] * vector.broadcast<3>();
+}
+
+inline Vec4 transform(const Mat4 &matrix, const Vec4 &vector) {
+  return transform_transposed(transpose(matrix), vector);
+}
+
+// Transforms every vector by the matrix, output may alias input.
+void transform(const Mat4 &matrix, std::span<const std::array<float, 4>> vectors,
+               std::span<std::array<float, 4>> output);
+
+// The smallest ratio of a matrix's determinant to the product of its row lengths that inverse treats as invertible.
+constexpr float SINGULAR_THRESHOLD = 1e-6f;
+
+// The inverse by 2x2 block cofactors, without branching on pivots. Singular and nearly singular matrices, see
+// SINGULAR_THRESHOLD, give the identity.
+Mat4 inverse(const Mat4 &matrix);
+
+} // namespace darparu::renderer
@@ -0,0 +1,67 @@
+#include "darparu/renderer/static_mesh.h"
+#include "darparu/renderer/gl_error_macro.h"
+#include "darparu/renderer/gl_state.h"
+#include "darparu/renderer/memory_tracker.h"
+#include <numeric>
+#include <stdexcept>
+
+namespace darparu::renderer {
+
+StaticMesh::StaticMesh(std::span<const float> vertices, std::span<const unsigned int> indices,
+                       std::vector<GLint> attribute_sizes, std::string name)
+    : _attribute_sizes(std::move(attribute_sizes)), _vbo(0), _ebo(0), _vao(0), _index_count(indices.size()) {
+  const GLint stride = std::accumulate(_attribute_sizes.begin(), _attribute_sizes.end(), 0);
+  if (stride == 0 || vertices.size() % stride != 0)
+    throw std::invalid_argument("Vertices are not a whole number of vertices");
+
+  glGenBuffers(1, &_vbo);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _vbo);
+  glBufferData(GL_ARRAY_BUFFER, vertices.size_bytes(), vertices.data(), GL_STATIC_DRAW);
+  memory_tracker().track(MemoryKind::buffer, _vbo, vertices.size_bytes(), this, name);
+
+  glGenBuffers(1, &_ebo);
+  glGenVertexArrays(1, &_vao);
+  gl_state().bind_vertex_array(_vao);
+  gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), GL_STATIC_DRAW);
+  memory_tracker().track(MemoryKind::buffer, _ebo, indices.size_bytes(), this, std::move(name));
+  bind_attributes();
+  gl_state().bind_vertex_array(0);
+}
+
+StaticMesh::~StaticMesh() {
+  if (_vbo != 0)
+    gl_state().delete_buffer(_vbo);
+  if (_ebo != 0)
+    gl_state().delete_buffer(_ebo);
+  if (_vao != 0)
+    gl_state().delete_vertex_array(_vao);
+}
+
+void StaticMesh::bind_attributes() const {
+  const GLint stride = std::accumulate(_attribute_sizes.begin(), _attribute_sizes.end(), 0) * sizeof(float);
+  gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, _vbo);
+  size_t offset = 0;
+  for (GLuint location = 0; location < _attribute_sizes.size(); ++location) {
+    GL_CALL(glVertexAttribPointer(location, _attribute_sizes[location], GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<void *>(offset * sizeof(float))));
+    glEnableVertexAttribArray(location);
+    offset += _attribute_sizes[location];
+  }
+}
+
+void StaticMesh::draw() const {
+  gl_state().bind_vertex_array(_vao);
+  glDrawElements(GL_TRIANGLES, _index_count, GL_UNSIGNED_INT, nullptr);
+  gl_state().count_draw(GL_TRIANGLES, _index_count);
+}
+
+void StaticMesh::draw(GLsizei first_index, GLsizei index_count, GLint base_vertex) const {
+  gl_state().bind_vertex_array(_vao);
+  glDrawElementsBaseVertex(GL_TRIANGLES, index_count, GL_UNSIGNED_INT,
+                           reinterpret_cast<void *>(first_index * sizeof(unsigned int)), base_vertex);
+  gl_state().count_draw(GL_TRIANGLES, index_count);
+}
+
+} // namespace darparu::renderer
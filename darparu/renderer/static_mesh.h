@@ -0,0 +1,42 @@
+#pragma once
+#include <GL/glew.h>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace darparu::renderer {
+
+// An immutable indexed triangle mesh of interleaved float attributes, bound to locations 0, 1, ... in order.
+class StaticMesh {
+public:
+  // The name attributes the mesh's memory, see MemoryTracker.
+  StaticMesh(std::span<const float> vertices, std::span<const unsigned int> indices,
+             std::vector<GLint> attribute_sizes, std::string name = "StaticMesh");
+  ~StaticMesh();
+
+  StaticMesh(const StaticMesh &) = delete;
+  StaticMesh &operator=(const StaticMesh &) = delete;
+
+  StaticMesh(StaticMesh &&other) = delete;
+  StaticMesh &operator=(StaticMesh &&other) = delete;
+
+  GLuint vertex_array() const { return _vao; }
+  GLsizei index_count() const { return _index_count; }
+
+  // Sets up the mesh's buffers and attributes on the bound vertex array, for vertex arrays that add attributes of
+  // their own such as per instance data.
+  void bind_attributes() const;
+
+  void draw() const;
+  // Draws a sub range of the indices, which are relative to base_vertex.
+  void draw(GLsizei first_index, GLsizei index_count, GLint base_vertex) const;
+
+private:
+  std::vector<GLint> _attribute_sizes;
+  GLuint _vbo;
+  GLuint _ebo;
+  GLuint _vao;
+  GLsizei _index_count;
+};
+
+} // namespace darparu::renderer
@@ -1,4 +1,5 @@
 #include "darparu/renderer/texture.h"
+#include "darparu/renderer/gl_state.h"
 
 namespace darparu::renderer {
 
@@ -7,10 +8,9 @@ Texture::Texture(GLuint texture) : _texture(texture) {}
 Texture::~Texture() {}
 
 void Texture::use() {
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, _texture);
+  gl_state().bind_texture(0, GL_TEXTURE_2D, _texture);
 }
 
-void Texture::unuse() { glBindTexture(GL_TEXTURE_2D, 0); }
+void Texture::unuse() { gl_state().bind_texture(0, GL_TEXTURE_2D, 0); }
 
 } // namespace darparu::renderer
\ No newline at end of file
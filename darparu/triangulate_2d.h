@@ -1,4 +1,5 @@
 #pragma once
+#include "darparu/profile.h"
 #include <deque>
 #include <iostream>
 #include <limits>
@@ -6,6 +7,7 @@
 
 // Kudos to Claude 3.7 Sonnet thinking and whoever fed the beast.
 std::vector<std::vector<double>> triangulate_polygon(const std::vector<double> &vertices) {
+  DARPARU_PROFILE_ZONE("triangulate_polygon");
   // Result will contain all triangles as [x1,y1, x2,y2, x3,y3] triplets
   std::vector<std::vector<double>> triangles;
 